@@ -1,12 +1,11 @@
 #include <ctype.h>
-#include <netdb.h>
-#include <netinet/in.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/un.h>
 #include <unistd.h>
 
 #include <iostream>
@@ -15,85 +14,93 @@
 #include <string>
 
 const std::string USAGE = R"#(
-usage: hyprctl [command] [(opt)args]
+usage: hyprctl [(opt)flags] [command] [(opt)args]
     
+    flags:
+    -j -> output in JSON (with --batch: every command, as one array)
+    --batch -> execute a batch of commands, separated by ';' (a ';' inside quotes doesn't separate)
+
     monitors
     workspaces
     clients
     activewindow
     layers
+    glstats
+    dispatch [dispatcher] [args]
 )#";
 
-void request(std::string arg) {
-    const auto SERVERSOCKET = socket(AF_INET, SOCK_STREAM, 0);
+bool writeAll(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        const auto WRITTEN = write(fd, data, length);
 
-    if (SERVERSOCKET < 0) {
-        std::cout << "Couldn't open a socket (1)";
-        return;
+        if (WRITTEN <= 0)
+            return false;
+
+        data += WRITTEN;
+        length -= WRITTEN;
     }
 
-    const auto SERVER = gethostbyname("localhost");
+    return true;
+}
 
-    if (!SERVER) {
-        std::cout << "Couldn't get host (2)";
-        return;
-    }
+bool readAll(int fd, char* data, size_t length) {
+    while (length > 0) {
+        const auto READ = read(fd, data, length);
 
-    sockaddr_in serverAddress = {0};
-    serverAddress.sin_family = AF_INET;
-    bcopy((char*)SERVER->h_addr, (char*)&serverAddress.sin_addr.s_addr, SERVER->h_length);
+        if (READ <= 0)
+            return false;
 
-    std::ifstream socketPortStream;
-    socketPortStream.open("/tmp/hypr/.socket");
-    
-    if (!socketPortStream.good()) {
-        std::cout << "No socket port file (2a)";
-        return;
+        data += READ;
+        length -= READ;
     }
 
-    std::string port = "";
-    std::getline(socketPortStream, port);
-    socketPortStream.close();
+    return true;
+}
 
-    int portInt = 0;
-    try {
-        portInt = std::stoi(port.c_str());
-    } catch (...) {
-        std::cout << "Port not an int?! (2b)";
-        return;
-    }
+void request(std::string arg) {
+    const auto SERVERSOCKET = socket(AF_UNIX, SOCK_STREAM, 0);
 
-    if (portInt == 0) {
-        std::cout << "Port not an int?! (2c)";
+    if (SERVERSOCKET < 0) {
+        std::cout << "Couldn't open a socket (1)";
         return;
     }
-    
-    serverAddress.sin_port = portInt;
 
-    if (connect(SERVERSOCKET, (sockaddr*)&serverAddress, sizeof(serverAddress)) < 0) {
-        std::cout << "Couldn't connect to port " << port << " (3) Is Hyprland running?";
+    sockaddr_un serverAddress = {0};
+    serverAddress.sun_family = AF_UNIX;
+    strcpy(serverAddress.sun_path, "/tmp/hypr/.socket.sock");
+
+    if (connect(SERVERSOCKET, (sockaddr*)&serverAddress, SUN_LEN(&serverAddress)) < 0) {
+        std::cout << "Couldn't connect to /tmp/hypr/.socket.sock (3) Is Hyprland running?";
         return;
     }
 
-    auto sizeWritten = write(SERVERSOCKET, arg.c_str(), arg.length());
+    // length-prefixed both ways
+    const uint32_t REQUESTLENGTH = arg.length();
+    std::string frame((const char*)&REQUESTLENGTH, sizeof(REQUESTLENGTH));
+    frame += arg;
 
-    if (sizeWritten < 0) {
+    if (!writeAll(SERVERSOCKET, frame.c_str(), frame.length())) {
         std::cout << "Couldn't write (4)";
         return;
     }
 
-    char buffer[8192] = {0};
+    uint32_t replyLength = 0;
+
+    if (!readAll(SERVERSOCKET, (char*)&replyLength, sizeof(replyLength))) {
+        std::cout << "Couldn't read (5)";
+        return;
+    }
 
-    sizeWritten = read(SERVERSOCKET,buffer, 8192);
+    std::string reply(replyLength, '\0');
 
-    if (sizeWritten < 0) {
+    if (!readAll(SERVERSOCKET, reply.data(), replyLength)) {
         std::cout << "Couldn't read (5)";
         return;
     }
 
     close(SERVERSOCKET);
 
-    std::cout << std::string(buffer);
+    std::cout << reply;
 }
 
 int main(int argc, char** argv) {
@@ -104,11 +111,53 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    if (!strcmp(argv[1], "monitors")) request("monitors");
-    else if (!strcmp(argv[1], "clients")) request("clients");
-    else if (!strcmp(argv[1], "workspaces")) request("workspaces");
-    else if (!strcmp(argv[1], "activewindow")) request("activewindow");
-    else if (!strcmp(argv[1], "layers")) request("layers");
+    std::string prefix = "";
+    int commandIndex = 1;
+
+    if (!strcmp(argv[1], "-j")) {
+        prefix = "j/";
+        commandIndex = 2;
+
+        if (argc < 3) {
+            printf(USAGE.c_str());
+            return 1;
+        }
+    }
+
+    const auto COMMAND = argv[commandIndex];
+
+    // everything goes in one request, e.g. hyprctl --batch "dispatch workspace 2 ; j/clients"
+    // with -j every item replies in JSON, all of them in one array
+    if (!strcmp(COMMAND, "--batch")) {
+        if (argc < commandIndex + 2) {
+            printf(USAGE.c_str());
+            return 1;
+        }
+
+        request(prefix + "[[BATCH]]" + std::string(argv[commandIndex + 1]));
+        return 0;
+    }
+
+    if (!strcmp(COMMAND, "dispatch")) {
+        if (argc < commandIndex + 2) {
+            printf(USAGE.c_str());
+            return 1;
+        }
+
+        std::string dispatchRequest = "dispatch";
+        for (int i = commandIndex + 1; i < argc; ++i)
+            dispatchRequest += " " + std::string(argv[i]);
+
+        request(dispatchRequest);
+        return 0;
+    }
+
+    if (!strcmp(COMMAND, "monitors")) request(prefix + "monitors");
+    else if (!strcmp(COMMAND, "clients")) request(prefix + "clients");
+    else if (!strcmp(COMMAND, "workspaces")) request(prefix + "workspaces");
+    else if (!strcmp(COMMAND, "activewindow")) request(prefix + "activewindow");
+    else if (!strcmp(COMMAND, "layers")) request(prefix + "layers");
+    else if (!strcmp(COMMAND, "glstats")) request(prefix + "glstats");
     else {
         printf(USAGE.c_str());
         return 1;
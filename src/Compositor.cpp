@@ -1,4 +1,5 @@
 #include "Compositor.hpp"
+#include "debug/HyprCtl.hpp"
 
 CCompositor::CCompositor() {
     unlink("/tmp/hypr/hyprland.log");
@@ -7,19 +8,21 @@ CCompositor::CCompositor() {
 
     system("mkdir -p /tmp/hypr");
 
+    Debug::init();
+
     m_sWLDisplay = wl_display_create();
 
     m_sWLRBackend = wlr_backend_autocreate(m_sWLDisplay);
 
     if (!m_sWLRBackend) {
-        Debug::log(CRIT, "m_sWLRBackend was NULL!");
+        DEBUGLOG(CRIT, "m_sWLRBackend was NULL!");
         RIP("m_sWLRBackend NULL!");
         return;
     }
 
     m_iDRMFD = wlr_backend_get_drm_fd(m_sWLRBackend);
     if (m_iDRMFD < 0) {
-        Debug::log(CRIT, "Couldn't query the DRM FD!");
+        DEBUGLOG(CRIT, "Couldn't query the DRM FD!");
         RIP("DRMFD NULL!");
         return;
     }
@@ -27,7 +30,7 @@ CCompositor::CCompositor() {
     m_sWLRRenderer = wlr_gles2_renderer_create_with_drm_fd(m_iDRMFD);
 
     if (!m_sWLRRenderer) {
-        Debug::log(CRIT, "m_sWLRRenderer was NULL!");
+        DEBUGLOG(CRIT, "m_sWLRRenderer was NULL!");
         RIP("m_sWLRRenderer NULL!");
         return;
     }
@@ -37,7 +40,7 @@ CCompositor::CCompositor() {
     m_sWLRAllocator = wlr_allocator_autocreate(m_sWLRBackend, m_sWLRRenderer);
 
     if (!m_sWLRAllocator) {
-        Debug::log(CRIT, "m_sWLRAllocator was NULL!");
+        DEBUGLOG(CRIT, "m_sWLRAllocator was NULL!");
         RIP("m_sWLRAllocator NULL!");
         return;
     }
@@ -45,7 +48,7 @@ CCompositor::CCompositor() {
     m_sWLREGL = wlr_gles2_renderer_get_egl(m_sWLRRenderer);
 
     if (!m_sWLREGL) {
-        Debug::log(CRIT, "m_sWLREGL was NULL!");
+        DEBUGLOG(CRIT, "m_sWLREGL was NULL!");
         RIP("m_sWLREGL NULL!");
         return;
     }
@@ -129,37 +132,44 @@ void CCompositor::startCompositor() {
     // Init all the managers BEFORE we start with the wayland server so that ALL of the stuff is initialized
     // properly and we dont get any bad mem reads.
     //
-    Debug::log(LOG, "Creating the CHyprError!");
+    DEBUGLOG(LOG, "Creating the CHyprError!");
     g_pHyprError = std::make_unique<CHyprError>();
     
-    Debug::log(LOG, "Creating the KeybindManager!");
+    DEBUGLOG(LOG, "Creating the KeybindManager!");
     g_pKeybindManager = std::make_unique<CKeybindManager>();
 
-    Debug::log(LOG, "Creating the ConfigManager!");
+    DEBUGLOG(LOG, "Creating the ConfigManager!");
     g_pConfigManager = std::make_unique<CConfigManager>();
 
-    Debug::log(LOG, "Creating the ThreadManager!");
-    g_pThreadManager = std::make_unique<CThreadManager>();
-
-    Debug::log(LOG, "Creating the InputManager!");
+    DEBUGLOG(LOG, "Creating the InputManager!");
     g_pInputManager = std::make_unique<CInputManager>();
 
-    Debug::log(LOG, "Creating the CHyprOpenGLImpl!");
+    DEBUGLOG(LOG, "Creating the CHyprOpenGLImpl!");
     g_pHyprOpenGL = std::make_unique<CHyprOpenGLImpl>();
 
-    Debug::log(LOG, "Creating the HyprRenderer!");
+    DEBUGLOG(LOG, "Creating the HyprRenderer!");
     g_pHyprRenderer = std::make_unique<CHyprRenderer>();
 
-    Debug::log(LOG, "Creating the XWaylandManager!");
+    DEBUGLOG(LOG, "Creating the XWaylandManager!");
     g_pXWaylandManager = std::make_unique<CHyprXWaylandManager>();
 
-    Debug::log(LOG, "Creating the LayoutManager!");
+    DEBUGLOG(LOG, "Creating the LayoutManager!");
     g_pLayoutManager = std::make_unique<CLayoutManager>();
 
-    Debug::log(LOG, "Creating the AnimationManager!");
+    DEBUGLOG(LOG, "Creating the AnimationManager!");
     g_pAnimationManager = std::make_unique<CAnimationManager>();
-    //
-    //
+
+    DEBUGLOG(LOG, "Creating the EventManager!");
+    g_pEventManager = std::make_unique<CEventManager>();
+
+    // loads the config, so everything it touches has to exist by now.
+    // Config watching and IPC are dispatched from the main event loop, none of it has a thread of its own.
+    DEBUGLOG(LOG, "Loading the config!");
+    g_pConfigManager->init();
+
+    DEBUGLOG(LOG, "Starting the IPC sockets!");
+    HyprCtl::startHyprCtlSocket();
+    g_pEventManager->startSocket();
 
     initAllSignals();
 
@@ -175,7 +185,7 @@ void CCompositor::startCompositor() {
     m_szWLDisplaySocket = wl_display_add_socket_auto(m_sWLDisplay);
 
     if (!m_szWLDisplaySocket) {
-        Debug::log(CRIT, "m_szWLDisplaySocket NULL!");
+        DEBUGLOG(CRIT, "m_szWLDisplaySocket NULL!");
         wlr_backend_destroy(m_sWLRBackend);
         RIP("m_szWLDisplaySocket NULL!");
     }
@@ -184,10 +194,10 @@ void CCompositor::startCompositor() {
 
     signal(SIGPIPE, SIG_IGN);
 
-    Debug::log(LOG, "Running on WAYLAND_DISPLAY: %s", m_szWLDisplaySocket);
+    DEBUGLOG(LOG, "Running on WAYLAND_DISPLAY: %s", m_szWLDisplaySocket);
 
     if (!wlr_backend_start(m_sWLRBackend)) {
-        Debug::log(CRIT, "Backend did not start!");
+        DEBUGLOG(CRIT, "Backend did not start!");
         wlr_backend_destroy(m_sWLRBackend);
         wl_display_destroy(m_sWLDisplay);
         RIP("Backend did not start!");
@@ -196,18 +206,14 @@ void CCompositor::startCompositor() {
     wlr_xcursor_manager_set_cursor_image(m_sWLRXCursorMgr, "left_ptr", m_sWLRCursor);
 
     // This blocks until we are done.
-    Debug::log(LOG, "Hyprland is ready, running the event loop!");
+    DEBUGLOG(LOG, "Hyprland is ready, running the event loop!");
     wl_display_run(m_sWLDisplay);
 }
 
 SMonitor* CCompositor::getMonitorFromID(const int& id) {
-    for (auto& m : m_lMonitors) {
-        if (m.ID == (uint64_t)id) {
-            return &m;
-        }
-    }
+    const auto IT = m_mMonitorIDs.find((uint64_t)id);
 
-    return nullptr;
+    return IT == m_mMonitorIDs.end() ? nullptr : IT->second;
 }
 
 SMonitor* CCompositor::getMonitorFromCursor() {
@@ -215,7 +221,7 @@ SMonitor* CCompositor::getMonitorFromCursor() {
     const auto OUTPUT = wlr_output_layout_output_at(m_sWLROutputLayout, COORDS.x, COORDS.y);
 
     if (!OUTPUT) {
-        Debug::log(WARN, "getMonitorFromCursor: cursor outside monitors??");
+        DEBUGLOG(WARN, "getMonitorFromCursor: cursor outside monitors??");
         return &m_lMonitors.front();
     }
 
@@ -224,7 +230,7 @@ SMonitor* CCompositor::getMonitorFromCursor() {
             return &m;
     }
 
-    Debug::log(LOG, "Monitor not in list??");
+    DEBUGLOG(LOG, "Monitor not in list??");
 
     return &m_lMonitors.front();
 }
@@ -233,7 +239,7 @@ SMonitor* CCompositor::getMonitorFromVector(const Vector2D& point) {
     const auto OUTPUT = wlr_output_layout_output_at(m_sWLROutputLayout, point.x, point.y);
 
     if (!OUTPUT) {
-        Debug::log(WARN, "getMonitorFromVector: vector outside monitors? Returning front");
+        DEBUGLOG(WARN, "getMonitorFromVector: vector outside monitors? Returning front");
         return &m_lMonitors.front();
     }
 
@@ -241,93 +247,76 @@ SMonitor* CCompositor::getMonitorFromVector(const Vector2D& point) {
 }
 
 void CCompositor::removeWindowFromVectorSafe(CWindow* pWindow) {
-    if (windowExists(pWindow) && !pWindow->m_bFadingOut)
-        m_lWindows.remove(*pWindow);
+    if (windowExists(pWindow) && !pWindow->m_bFadingOut) {
+        m_WindowRegistry.remove(pWindow);
+        sceneChanged();
+        unlistWindowFromWorkspace(pWindow);
+        m_lWindows.remove_if([&](CWindow& el) { return &el == pWindow; });
+    }
 }
 
 bool CCompositor::windowExists(CWindow* pWindow) {
-    for (auto& w : m_lWindows) {
-        if (&w == pWindow)
-            return true;
-    }
-
-    return false;
+    return m_WindowRegistry.contains(pWindow);
 }
 
 CWindow* CCompositor::vectorToWindow(const Vector2D& pos) {
     const auto PMONITOR = getMonitorFromVector(pos);
-    // first loop over floating cuz they're above, m_lWindows should be sorted bottom->top, for tiled it doesn't matter.
-    for (auto w = m_lWindows.rbegin(); w != m_lWindows.rend(); w++) {
-        wlr_box box = {w->m_vRealPosition.x, w->m_vRealPosition.y, w->m_vRealSize.x, w->m_vRealSize.y};
-        if (wlr_box_contains_point(&box, pos.x, pos.y) && w->m_bIsMapped && w->m_bIsFloating && isWorkspaceVisible(w->m_iWorkspaceID) && !w->m_bHidden)
-            return &(*w);
-    }
+    // first check floating cuz they're above, the index keeps m_lWindows' bottom->top order
+    const auto PFLOATING = m_WindowIndex.windowAt(pos, true, [&](CWindow* w) {
+        return w->m_bIsMapped && w->m_bIsFloating && isWorkspaceVisible(w->m_iWorkspaceID) && !w->m_bHidden;
+    });
 
-    for (auto& w : m_lWindows) {
-        wlr_box box = {w.m_vRealPosition.x, w.m_vRealPosition.y, w.m_vRealSize.x, w.m_vRealSize.y};
-        if (wlr_box_contains_point(&box, pos.x, pos.y) && w.m_bIsMapped && !w.m_bIsFloating && PMONITOR->activeWorkspace == w.m_iWorkspaceID && !w.m_bHidden)
-            return &w;
-    }
+    if (PFLOATING)
+        return PFLOATING;
 
-    return nullptr;
+    return m_WindowIndex.windowAt(pos, true, [&](CWindow* w) {
+        return w->m_bIsMapped && !w->m_bIsFloating && PMONITOR->activeWorkspace == w->m_iWorkspaceID && !w->m_bHidden;
+    });
 }
 
 CWindow* CCompositor::vectorToWindowTiled(const Vector2D& pos) {
     const auto PMONITOR = getMonitorFromVector(pos);
-    for (auto& w : m_lWindows) {
-        wlr_box box = {w.m_vPosition.x, w.m_vPosition.y, w.m_vSize.x, w.m_vSize.y};
-        if (w.m_bIsMapped && wlr_box_contains_point(&box, pos.x, pos.y) && w.m_iWorkspaceID == PMONITOR->activeWorkspace && !w.m_bIsFloating && !w.m_bHidden)
-            return &w;
-    }
-
-    return nullptr;
+    return m_WindowIndex.windowAt(pos, false, [&](CWindow* w) {
+        return w->m_bIsMapped && w->m_iWorkspaceID == PMONITOR->activeWorkspace && !w->m_bIsFloating && !w->m_bHidden;
+    });
 }
 
 CWindow* CCompositor::vectorToWindowIdeal(const Vector2D& pos) {
     const auto PMONITOR = getMonitorFromVector(pos);
-    // first loop over floating cuz they're above, m_lWindows should be sorted bottom->top, for tiled it doesn't matter.
-    for (auto w = m_lWindows.rbegin(); w != m_lWindows.rend(); w++) {
-        wlr_box box = {w->m_vRealPosition.x, w->m_vRealPosition.y, w->m_vRealSize.x, w->m_vRealSize.y};
-        if (w->m_bIsFloating && w->m_bIsMapped && wlr_box_contains_point(&box, m_sWLRCursor->x, m_sWLRCursor->y) && isWorkspaceVisible(w->m_iWorkspaceID) && !w->m_bHidden)
-            return &(*w);
-    }
+    // first check floating cuz they're above, the index keeps m_lWindows' bottom->top order
+    const auto PFLOATING = m_WindowIndex.windowAt(Vector2D(m_sWLRCursor->x, m_sWLRCursor->y), true, [&](CWindow* w) {
+        return w->m_bIsFloating && w->m_bIsMapped && isWorkspaceVisible(w->m_iWorkspaceID) && !w->m_bHidden;
+    });
 
-    for (auto& w : m_lWindows) {
-        wlr_box box = {w.m_vPosition.x, w.m_vPosition.y, w.m_vSize.x, w.m_vSize.y};
-        if (!w.m_bIsFloating && w.m_bIsMapped && wlr_box_contains_point(&box, pos.x, pos.y) && w.m_iWorkspaceID == PMONITOR->activeWorkspace && !w.m_bHidden)
-            return &w;
-    }
+    if (PFLOATING)
+        return PFLOATING;
 
-    return nullptr;
+    return m_WindowIndex.windowAt(pos, false, [&](CWindow* w) {
+        return !w->m_bIsFloating && w->m_bIsMapped && w->m_iWorkspaceID == PMONITOR->activeWorkspace && !w->m_bHidden;
+    });
 }
 
 CWindow* CCompositor::windowFromCursor() {
     const auto PMONITOR = getMonitorFromCursor();
+    const auto CURSORPOS = Vector2D(m_sWLRCursor->x, m_sWLRCursor->y);
 
-    // first loop over floating cuz they're above, m_lWindows should be sorted bottom->top, for tiled it doesn't matter.
-    for (auto w = m_lWindows.rbegin(); w != m_lWindows.rend(); w++) {
-        wlr_box box = {w->m_vRealPosition.x, w->m_vRealPosition.y, w->m_vRealSize.x, w->m_vRealSize.y};
-        if (wlr_box_contains_point(&box, m_sWLRCursor->x, m_sWLRCursor->y) && w->m_bIsMapped && w->m_bIsFloating && isWorkspaceVisible(w->m_iWorkspaceID))
-            return &(*w);
-    }
+    // first check floating cuz they're above, the index keeps m_lWindows' bottom->top order
+    const auto PFLOATING = m_WindowIndex.windowAt(CURSORPOS, true, [&](CWindow* w) {
+        return w->m_bIsMapped && w->m_bIsFloating && isWorkspaceVisible(w->m_iWorkspaceID);
+    });
 
-    for (auto& w : m_lWindows) {
-        wlr_box box = {w.m_vPosition.x, w.m_vPosition.y, w.m_vSize.x, w.m_vSize.y};
-        if (wlr_box_contains_point(&box, m_sWLRCursor->x, m_sWLRCursor->y) && w.m_bIsMapped && w.m_iWorkspaceID == PMONITOR->activeWorkspace)
-            return &w;
-    }
+    if (PFLOATING)
+        return PFLOATING;
 
-    return nullptr;
+    return m_WindowIndex.windowAt(CURSORPOS, false, [&](CWindow* w) {
+        return w->m_bIsMapped && w->m_iWorkspaceID == PMONITOR->activeWorkspace;
+    });
 }
 
 CWindow* CCompositor::windowFloatingFromCursor() {
-    for (auto w = m_lWindows.rbegin(); w != m_lWindows.rend(); w++) {
-        wlr_box box = {w->m_vRealPosition.x, w->m_vRealPosition.y, w->m_vRealSize.x, w->m_vRealSize.y};
-        if (wlr_box_contains_point(&box, m_sWLRCursor->x, m_sWLRCursor->y) && w->m_bIsMapped && w->m_bIsFloating && isWorkspaceVisible(w->m_iWorkspaceID) && !w->m_bHidden)
-            return &(*w);
-    }
-
-    return nullptr;
+    return m_WindowIndex.windowAt(Vector2D(m_sWLRCursor->x, m_sWLRCursor->y), true, [&](CWindow* w) {
+        return w->m_bIsMapped && w->m_bIsFloating && isWorkspaceVisible(w->m_iWorkspaceID) && !w->m_bHidden;
+    });
 }
 
 wlr_surface* CCompositor::vectorWindowToSurface(const Vector2D& pos, CWindow* pWindow, Vector2D& sl) {
@@ -356,19 +345,15 @@ wlr_surface* CCompositor::vectorWindowToSurface(const Vector2D& pos, CWindow* pW
 }
 
 SMonitor* CCompositor::getMonitorFromOutput(wlr_output* out) {
-    for (auto& m : m_lMonitors) {
-        if (m.output == out) {
-            return &m;
-        }
-    }
+    const auto IT = m_mOutputMonitors.find(out);
 
-    return nullptr;
+    return IT == m_mOutputMonitors.end() ? nullptr : IT->second;
 }
 
 void CCompositor::focusWindow(CWindow* pWindow, wlr_surface* pSurface) {
 
     if (g_pCompositor->m_sSeat.exclusiveClient) {
-        Debug::log(LOG, "Disallowing setting focus to a window due to there being an active input inhibitor layer.");
+        DEBUGLOG(LOG, "Disallowing setting focus to a window due to there being an active input inhibitor layer.");
         return;
     }
 
@@ -395,6 +380,9 @@ void CCompositor::focusWindow(CWindow* pWindow, wlr_surface* pSurface) {
     const auto POINTERLOCAL = g_pInputManager->getMouseCoordsInternal() - pWindow->m_vRealPosition;
     wlr_seat_pointer_notify_enter(m_sSeat.seat, PWINDOWSURFACE, POINTERLOCAL.x, POINTERLOCAL.y);
 
+    if (m_pLastWindow != pWindow)
+        g_pEventManager->postEvent(SHyprIPCEvent{"activewindow", g_pXWaylandManager->getAppIDClass(pWindow) + "," + pWindow->m_szTitle});
+
     m_pLastWindow = pWindow;
 }
 
@@ -425,15 +413,25 @@ void CCompositor::focusSurface(wlr_surface* pSurface, CWindow* pWindowOwner) {
     wlr_signal_emit_safe(&m_sSeat.seat->keyboard_state.events.focus_change, &event);
 
     if (pWindowOwner)
-        Debug::log(LOG, "Set keyboard focus to surface %x, with window name: %s", pSurface, pWindowOwner->m_szTitle.c_str());
+        DEBUGLOG(LOG, "Set keyboard focus to surface %x, with window name: %s", pSurface, pWindowOwner->m_szTitle.c_str());
     else
-        Debug::log(LOG, "Set keyboard focus to surface %x", pSurface);
+        DEBUGLOG(LOG, "Set keyboard focus to surface %x", pSurface);
 }
 
 bool CCompositor::windowValidMapped(CWindow* pWindow) {
     if (!windowExists(pWindow))
         return false;
 
+    return windowValidMapped(CWindowHandle(pWindow));
+}
+
+bool CCompositor::windowValidMapped(const CWindowHandle& window) {
+    // a handle only resolves to windows that still exist, no lookup by pointer needed
+    const auto pWindow = window.get();
+
+    if (!pWindow)
+        return false;
+
     if (pWindow->m_bIsX11 && !pWindow->m_bMappedX11)
         return false;
 
@@ -450,12 +448,9 @@ bool CCompositor::windowValidMapped(CWindow* pWindow) {
 }
 
 CWindow* CCompositor::getWindowForPopup(wlr_xdg_popup* popup) {
-    for (auto& p : m_lXDGPopups) {
-        if (p.popup == popup)
-            return p.parentWindow;
-    }
+    const auto IT = m_mPopups.find(popup);
 
-    return nullptr;
+    return IT == m_mPopups.end() ? nullptr : m_WindowRegistry.get(IT->second->parentWindow);
 }
 
 wlr_surface* CCompositor::vectorToLayerSurface(const Vector2D& pos, std::list<SLayerSurface*>* layerSurfaces, Vector2D* sCoords) {
@@ -473,23 +468,91 @@ wlr_surface* CCompositor::vectorToLayerSurface(const Vector2D& pos, std::list<SL
 }
 
 CWindow* CCompositor::getWindowFromSurface(wlr_surface* pSurface) {
-    for (auto& w : m_lWindows) {
-        if (g_pXWaylandManager->getWindowSurface(&w) == pSurface)
-            return &w;
-    }
+    const auto IT = m_mSurfaceWindows.find(pSurface);
 
-    return nullptr;
+    return IT == m_mSurfaceWindows.end() ? nullptr : IT->second;
+}
+
+// the surface and all of its subsurfaces -> pWindow
+void CCompositor::indexSurfaceTree(wlr_surface* pSurface, CWindow* pWindow) {
+    wlr_surface_for_each_surface(pSurface, [](wlr_surface* surface, int x, int y, void* data) { g_pCompositor->m_mSurfaceWindows[surface] = (CWindow*)data; }, pWindow);
+}
+
+void CCompositor::unindexSurfaceTree(wlr_surface* pSurface) {
+    wlr_surface_for_each_surface(pSurface, [](wlr_surface* surface, int x, int y, void* data) { g_pCompositor->m_mSurfaceWindows.erase(surface); }, nullptr);
 }
 
 CWindow* CCompositor::getFullscreenWindowOnWorkspace(const int& ID) {
-    for (auto& w : m_lWindows) {
-        if (w.m_iWorkspaceID == ID && w.m_bIsFullscreen)
-            return &w;
+    const auto IT = m_mWorkspaceWindows.find(ID);
+
+    if (IT == m_mWorkspaceWindows.end())
+        return nullptr;
+
+    for (auto& w : IT->second.windows) {
+        if (w->m_bIsFullscreen)
+            return w;
     }
 
     return nullptr;
 }
 
+void CCompositor::unlistWindowFromWorkspace(CWindow* pWindow) {
+    const auto IT = m_mWorkspaceWindows.find(pWindow->m_iWorkspaceID);
+
+    if (IT == m_mWorkspaceWindows.end())
+        return;
+
+    auto& windows = IT->second.windows;
+    const auto POS = std::find(windows.begin(), windows.end(), pWindow);
+
+    if (POS == windows.end())
+        return;
+
+    windows.erase(POS);
+
+    if (pWindow->m_bIsMapped)
+        IT->second.mappedCount--;
+
+    if (windows.empty())
+        m_mWorkspaceWindows.erase(IT);
+}
+
+void CCompositor::setWindowWorkspace(CWindow* pWindow, const int& id) {
+    if (pWindow->m_iWorkspaceID == id) {
+        const auto IT = m_mWorkspaceWindows.find(id);
+        if (IT != m_mWorkspaceWindows.end() && std::find(IT->second.windows.begin(), IT->second.windows.end(), pWindow) != IT->second.windows.end())
+            return;
+    }
+
+    unlistWindowFromWorkspace(pWindow);
+
+    pWindow->m_iWorkspaceID = id;
+
+    auto& workspaceWindows = m_mWorkspaceWindows[id];
+    workspaceWindows.windows.push_back(pWindow);
+
+    if (pWindow->m_bIsMapped)
+        workspaceWindows.mappedCount++;
+
+    sceneChanged();
+}
+
+void CCompositor::setWindowMapped(CWindow* pWindow, bool mapped) {
+    if (pWindow->m_bIsMapped == mapped)
+        return;
+
+    pWindow->m_bIsMapped = mapped;
+
+    sceneChanged();
+
+    const auto IT = m_mWorkspaceWindows.find(pWindow->m_iWorkspaceID);
+
+    if (IT == m_mWorkspaceWindows.end() || std::find(IT->second.windows.begin(), IT->second.windows.end(), pWindow) == IT->second.windows.end())
+        return;
+
+    IT->second.mappedCount += mapped ? 1 : -1;
+}
+
 bool CCompositor::isWorkspaceVisible(const int& w) {
     for (auto& m : m_lMonitors) {
         if (m.activeWorkspace == w)
@@ -500,39 +563,71 @@ bool CCompositor::isWorkspaceVisible(const int& w) {
 }
 
 CWorkspace* CCompositor::getWorkspaceByID(const int& id) {
-    for (auto& w : m_lWorkspaces) {
-        if (w.m_iID == id)
-            return &w;
+    const auto IT = m_mWorkspaceIDs.find(id);
+
+    return IT == m_mWorkspaceIDs.end() ? nullptr : IT->second;
+}
+
+void CCompositor::sceneChanged() {
+    m_iSceneEpoch++;
+}
+
+void CCompositor::windowGeometryChanged(CWindow* pWindow) {
+    m_iGeometryEpoch++;
+    m_WindowIndex.windowMoved(pWindow);
+}
+
+void CCompositor::checkIndexConsistency() {
+    // walks every list and makes sure the lookup indices agree with it. Debug builds run this every frame.
+    for (auto& w : m_lWindows) {
+        RASSERT(m_WindowRegistry.contains(&w), "Window %x is missing from the registry", &w);
+
+        const auto PSURFACE = g_pXWaylandManager->getWindowSurface(&w);
+        if (w.m_bIsMapped && PSURFACE)
+            RASSERT(getWindowFromSurface(PSURFACE) == &w, "Surface index out of sync for window %x", &w);
     }
 
-    return nullptr;
+    // subsurfaces come and go on their own, so no exact count, but nothing may point at a window that's gone or unmapped
+    for (auto& [surface, pWindow] : m_mSurfaceWindows)
+        RASSERT(m_WindowRegistry.contains(pWindow) && pWindow->m_bIsMapped, "Surface %x is indexed to dead or unmapped window %x", surface, pWindow);
+
+    for (auto& p : m_lXDGPopups)
+        RASSERT(m_mPopups.contains(p.popup) && m_mPopups[p.popup] == &p, "Popup index out of sync for popup %x", &p);
+    RASSERT(m_mPopups.size() == m_lXDGPopups.size(), "Popup index has %i entries, expected %i", (int)m_mPopups.size(), (int)m_lXDGPopups.size());
+
+    for (auto& m : m_lMonitors) {
+        RASSERT(getMonitorFromOutput(m.output) == &m, "Output index out of sync for monitor %s", m.szName.c_str());
+        RASSERT(getMonitorFromID(m.ID) == &m, "Monitor ID index out of sync for monitor %s", m.szName.c_str());
+    }
+    RASSERT(m_mOutputMonitors.size() == m_lMonitors.size() && m_mMonitorIDs.size() == m_lMonitors.size(), "Monitor indices have stale entries");
+
+    for (auto& w : m_lWorkspaces)
+        RASSERT(getWorkspaceByID(w.m_iID) == &w, "Workspace index out of sync for workspace %i", w.m_iID);
+    RASSERT(m_mWorkspaceIDs.size() == m_lWorkspaces.size(), "Workspace index has %i entries, expected %i", (int)m_mWorkspaceIDs.size(), (int)m_lWorkspaces.size());
 }
 
 void CCompositor::sanityCheckWorkspaces() {
-    for (auto it = m_lWorkspaces.begin(); it != m_lWorkspaces.end(); ++it) {
+    // called when a workspace may have become empty or hidden: on unmap, window moves and workspace switches
+    for (auto it = m_lWorkspaces.begin(); it != m_lWorkspaces.end();) {
         if (getWindowsOnWorkspace(it->m_iID) == 0 && !isWorkspaceVisible(it->m_iID)) {
+            m_mWorkspaceIDs.erase(it->m_iID);
             it = m_lWorkspaces.erase(it);
         }
+        else
+            ++it;
     }
 }
 
 int CCompositor::getWindowsOnWorkspace(const int& id) {
-    int no = 0;
-    for (auto& w : m_lWindows) {
-        if (w.m_iWorkspaceID == id && w.m_bIsMapped)
-            no++;
-    }
+    const auto IT = m_mWorkspaceWindows.find(id);
 
-    return no;
+    return IT == m_mWorkspaceWindows.end() ? 0 : IT->second.mappedCount;
 }
 
 CWindow* CCompositor::getFirstWindowOnWorkspace(const int& id) {
-    for (auto& w : m_lWindows) {
-        if (w.m_iWorkspaceID == id)
-            return &w;
-    }
+    const auto IT = m_mWorkspaceWindows.find(id);
 
-    return nullptr;
+    return IT == m_mWorkspaceWindows.end() ? nullptr : IT->second.windows.front();
 }
 
 void CCompositor::fixXWaylandWindowsOnWorkspace(const int& id) {
@@ -540,17 +635,19 @@ void CCompositor::fixXWaylandWindowsOnWorkspace(const int& id) {
 
     const auto PWORKSPACE = g_pCompositor->getWorkspaceByID(id);
 
-    for (auto& w : m_lWindows) {
-        if (w.m_iWorkspaceID == id) {
-
-            // moveXWaylandWindow only moves XWayland windows
-            // so there is no need to check here
-            // if the window is XWayland or not.
-            if (ISVISIBLE && (!PWORKSPACE->m_bHasFullscreenWindow || w.m_bIsFullscreen))
-                g_pXWaylandManager->moveXWaylandWindow(&w, w.m_vRealPosition);
-            else 
-                g_pXWaylandManager->moveXWaylandWindow(&w, Vector2D(42069,42069));
-        }
+    const auto IT = m_mWorkspaceWindows.find(id);
+
+    if (IT == m_mWorkspaceWindows.end())
+        return;
+
+    for (auto& w : IT->second.windows) {
+        // moveXWaylandWindow only moves XWayland windows
+        // so there is no need to check here
+        // if the window is XWayland or not.
+        if (ISVISIBLE && (!PWORKSPACE->m_bHasFullscreenWindow || w->m_bIsFullscreen))
+            g_pXWaylandManager->moveXWaylandWindow(w, w->m_vRealPosition);
+        else 
+            g_pXWaylandManager->moveXWaylandWindow(w, Vector2D(42069,42069));
     }
 }
 
@@ -574,9 +671,17 @@ void CCompositor::moveWindowToTop(CWindow* pWindow) {
     for (auto it = m_lWindows.begin(); it != m_lWindows.end(); ++it) {
         if (&(*it) == pWindow) {
             m_lWindows.splice(m_lWindows.end(), m_lWindows, it);
+            sceneChanged();
             break;
         }
     }
+
+    // keep the workspace's list in the same order
+    if (const auto IT = m_mWorkspaceWindows.find(pWindow->m_iWorkspaceID); IT != m_mWorkspaceWindows.end()) {
+        auto& windows = IT->second.windows;
+        if (const auto POS = std::find(windows.begin(), windows.end(), pWindow); POS != windows.end())
+            std::rotate(POS, POS + 1, windows.end());
+    }
 }
 
 void CCompositor::cleanupWindows() {
@@ -587,10 +692,13 @@ void CCompositor::cleanupWindows() {
 
             g_pHyprOpenGL->m_mWindowFramebuffers[w].release();
             g_pHyprOpenGL->m_mWindowFramebuffers.erase(w);
-            m_lWindows.remove(*w);
+            m_WindowRegistry.remove(w);
+            sceneChanged();
+            unlistWindowFromWorkspace(w);
+            m_lWindows.remove_if([&](CWindow& el) { return &el == w; });
             m_lWindowsFadingOut.remove(w);
 
-            Debug::log(LOG, "Cleanup: destroyed a window");
+            DEBUGLOG(LOG, "Cleanup: destroyed a window");
             return;
         }
     }
@@ -665,23 +773,21 @@ void CCompositor::deactivateAllWLRWorkspaces() {
 }
 
 CWindow* CCompositor::getNextWindowOnWorkspace(CWindow* pWindow) {
-    bool gotToWindow = false;
-    for (auto& w : m_lWindows) {
-        if (&w != pWindow && !gotToWindow)
-            continue;
+    const auto IT = m_mWorkspaceWindows.find(pWindow->m_iWorkspaceID);
 
-        if (&w == pWindow) {
-            gotToWindow = true;
-            continue;
-        }
+    if (IT == m_mWorkspaceWindows.end())
+        return nullptr;
 
-        if (w.m_iWorkspaceID == pWindow->m_iWorkspaceID && windowValidMapped(&w))
-            return &w;
-    }
+    const auto& WINDOWS = IT->second.windows;
+    const auto POS = std::find(WINDOWS.begin(), WINDOWS.end(), pWindow);
 
-    for (auto& w : m_lWindows) {
-        if (&w != pWindow && w.m_iWorkspaceID == pWindow->m_iWorkspaceID && windowValidMapped(&w))
-            return &w;
+    // walk the workspace's windows once, starting after ours and wrapping around
+    const size_t START = POS == WINDOWS.end() ? 0 : POS - WINDOWS.begin() + 1;
+    for (size_t i = 0; i < WINDOWS.size(); ++i) {
+        const auto PCANDIDATE = WINDOWS[(START + i) % WINDOWS.size()];
+
+        if (PCANDIDATE != pWindow && windowValidMapped(PCANDIDATE))
+            return PCANDIDATE;
     }
 
     return nullptr;
@@ -3,19 +3,23 @@
 #include <memory>
 #include <deque>
 #include <list>
+#include <unordered_map>
+#include <algorithm>
 
 #include "defines.hpp"
 #include "debug/Log.hpp"
 #include "events/Events.hpp"
 #include "config/ConfigManager.hpp"
-#include "managers/ThreadManager.hpp"
 #include "managers/XWaylandManager.hpp"
 #include "managers/InputManager.hpp"
 #include "managers/LayoutManager.hpp"
 #include "managers/KeybindManager.hpp"
 #include "managers/AnimationManager.hpp"
+#include "managers/EventManager.hpp"
 #include "helpers/Monitor.hpp"
 #include "helpers/Workspace.hpp"
+#include "helpers/WindowRegistry.hpp"
+#include "helpers/SpatialIndex.hpp"
 #include "Window.hpp"
 #include "render/Renderer.hpp"
 #include "render/OpenGL.hpp"
@@ -65,10 +69,29 @@ public:
     std::list<SSubsurface>  m_lSubsurfaces;
     std::list<CWindow*>     m_lWindowsFadingOut;
 
+    CWindowRegistry         m_WindowRegistry; // every window in m_lWindows, by handle
+    // bumped by sceneChanged() on structural changes: windows mapped, unmapped, restacked, moved between workspaces,
+    // floated or fullscreened, workspaces switched, layouts recalculated, outputs changed, layers and the drag icon
+    // mapped or unmapped. Not by damage.
+    // Things derived from the window lists (hit-testing, render lists) rebuild when it moves on.
+    uint64_t                m_iSceneEpoch = 0;
+    // bumped by windowGeometryChanged() whenever a window's box moves, animations included. Call it after the move,
+    // the hit-testing index re-buckets the window from its new box right there.
+    uint64_t                m_iGeometryEpoch = 0;
+    CWindowSpatialIndex     m_WindowIndex; // pointer hit-testing, see vectorToWindow & co.
+    std::unordered_map<int, SWorkspaceWindows> m_mWorkspaceWindows;
+
+    // lookup indices over the lists above, kept in sync by the create/map/unmap/destroy listeners
+    std::unordered_map<wlr_surface*, CWindow*>      m_mSurfaceWindows; // mapped windows only, their subsurfaces included
+    std::unordered_map<wlr_xdg_popup*, SXDGPopup*>  m_mPopups;
+    std::unordered_map<wlr_output*, SMonitor*>      m_mOutputMonitors;
+    std::unordered_map<uint64_t, SMonitor*>         m_mMonitorIDs;
+    std::unordered_map<int, CWorkspace*>            m_mWorkspaceIDs;
+
     void                    startCompositor(); 
 
     wlr_surface*            m_pLastFocus = nullptr;
-    CWindow*                m_pLastWindow = nullptr;
+    CWindowHandle           m_pLastWindow;
     SMonitor*               m_pLastMonitor = nullptr;
     
     SSeat                   m_sSeat;
@@ -83,6 +106,7 @@ public:
     void                    focusSurface(wlr_surface*, CWindow* pWindowOwner = nullptr);
     bool                    windowExists(CWindow*);
     bool                    windowValidMapped(CWindow*);
+    bool                    windowValidMapped(const CWindowHandle&);
     CWindow*                vectorToWindow(const Vector2D&);
     CWindow*                vectorToWindowIdeal(const Vector2D&);
     CWindow*                vectorToWindowTiled(const Vector2D&);
@@ -93,6 +117,8 @@ public:
     SMonitor*               getMonitorFromOutput(wlr_output*);
     CWindow*                getWindowForPopup(wlr_xdg_popup*);
     CWindow*                getWindowFromSurface(wlr_surface*);
+    void                    indexSurfaceTree(wlr_surface*, CWindow*);
+    void                    unindexSurfaceTree(wlr_surface*);
     bool                    isWorkspaceVisible(const int&);
     CWorkspace*             getWorkspaceByID(const int&);
     void                    sanityCheckWorkspaces();
@@ -100,6 +126,11 @@ public:
     CWindow*                getFirstWindowOnWorkspace(const int&);
     void                    fixXWaylandWindowsOnWorkspace(const int&);
     CWindow*                getFullscreenWindowOnWorkspace(const int&);
+    void                    setWindowWorkspace(CWindow*, const int&);
+    void                    setWindowMapped(CWindow*, bool);
+    void                    checkIndexConsistency();
+    void                    sceneChanged();
+    void                    windowGeometryChanged(CWindow*);
     bool                    doesSeatAcceptInput(wlr_surface*);
     bool                    isWindowActive(CWindow*);
     void                    moveWindowToTop(CWindow*);
@@ -110,6 +141,7 @@ public:
 
 private:
     void                    initAllSignals();
+    void                    unlistWindowFromWorkspace(CWindow*);
 };
 
 
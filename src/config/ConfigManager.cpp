@@ -2,6 +2,7 @@
 #include "../managers/KeybindManager.hpp"
 
 #include <string.h>
+#include <sys/inotify.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -12,6 +13,37 @@
 
 CConfigManager::CConfigManager() {
     setDefaultVars();
+
+    for (auto& [key, value] : configValues) {
+        m_mConfigSlots[key] = m_vSlotKeys.size();
+        m_vSlotKeys.push_back(key);
+    }
+
+    publishSnapshot();
+}
+
+void CConfigManager::publishSnapshot() {
+    auto newSnapshot = std::make_unique<SConfigSnapshot>(m_vSlotKeys.size());
+
+    for (size_t i = 0; i < m_vSlotKeys.size(); ++i)
+        (*newSnapshot)[i] = configValues[m_vSlotKeys[i]];
+
+    m_pLiveSnapshot.store(newSnapshot.get(), std::memory_order_release);
+
+    m_pRetiredSnapshot = std::move(m_pCurrentSnapshot);
+    m_pCurrentSnapshot = std::move(newSnapshot);
+}
+
+size_t CConfigManager::getSlot(const std::string& name) {
+    const auto IT = m_mConfigSlots.find(name);
+
+    RASSERT(IT != m_mConfigSlots.end(), "Config handle requested for an unknown value %s", name.c_str());
+
+    return IT->second;
+}
+
+const SConfigSnapshot& CConfigManager::getLiveSnapshot() {
+    return *m_pLiveSnapshot.load(std::memory_order_acquire);
 }
 
 void CConfigManager::setDefaultVars() {
@@ -21,8 +53,10 @@ void CConfigManager::setDefaultVars() {
     configValues["general:main_mod"].strValue = "SUPER";                                               // exposed to the user for easier configuring
     configValues["general:main_mod_internal"].intValue = g_pKeybindManager->stringToModMask("SUPER");  // actually used and automatically calculated
 
-    configValues["general:damage_tracking"].strValue = "none";
-    configValues["general:damage_tracking_internal"].intValue = DAMAGE_TRACKING_NONE;
+    configValues["general:damage_tracking"].strValue = "full";
+    configValues["general:damage_tracking_internal"].intValue = DAMAGE_TRACKING_FULL;
+    configValues["general:direct_scanout"].intValue = 1;
+    configValues["general:bypass_primary_fb"].intValue = 1;
 
     configValues["general:border_size"].intValue = 1;
     configValues["general:gaps_in"].intValue = 5;
@@ -34,6 +68,8 @@ void CConfigManager::setDefaultVars() {
     configValues["decoration:blur"].intValue = 1;
     configValues["decoration:blur_size"].intValue = 8;
     configValues["decoration:blur_passes"].intValue = 1;
+    configValues["decoration:blur_method"].strValue = "gaussian";
+    configValues["decoration:blur_method_internal"].intValue = BLUR_METHOD_GAUSSIAN;
     configValues["decoration:active_opacity"].floatValue = 1;
     configValues["decoration:inactive_opacity"].floatValue = 1;
 
@@ -58,6 +94,8 @@ void CConfigManager::setDefaultVars() {
 
     configValues["input:follow_mouse"].intValue = 1;
 
+    configValues["debug:log_level"].intValue = LOG;
+
     configValues["autogenerated"].intValue = 0;
 }
 
@@ -65,19 +103,64 @@ void CConfigManager::init() {
     
     loadConfigLoadVars();
 
+    isFirstLaunch = false;
+
+    startWatchingConfig();
+}
+
+void CConfigManager::startWatchingConfig() {
     const char* const ENVHOME = getenv("HOME");
+    const std::string CONFIGDIR = ENVHOME + (std::string) "/.config/hypr";
+    m_szConfigFileName = ISDEBUG ? "hyprlandd.conf" : "hyprland.conf";
 
-    const std::string CONFIGPATH = ENVHOME + (ISDEBUG ? (std::string) "/.config/hypr/hyprlandd.conf" : (std::string) "/.config/hypr/hyprland.conf");
+    m_iInotifyFD = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
 
-    struct stat fileStat;
-    int err = stat(CONFIGPATH.c_str(), &fileStat);
-    if (err != 0) {
-        Debug::log(WARN, "Error at statting config, error %i", errno);
+    if (m_iInotifyFD < 0) {
+        DEBUGLOG(ERR, "Config: inotify_init1 failed (%s), the config won't be reloaded automatically", strerror(errno));
+        return;
     }
 
-    lastModifyTime = fileStat.st_mtime;
+    // watch the directory, not the file: editors tend to save by replacing the file, which would drop a watch on it
+    if (inotify_add_watch(m_iInotifyFD, CONFIGDIR.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM) < 0) {
+        DEBUGLOG(ERR, "Config: couldn't watch %s (%s), the config won't be reloaded automatically", CONFIGDIR.c_str(), strerror(errno));
+        close(m_iInotifyFD);
+        m_iInotifyFD = -1;
+        return;
+    }
 
-    isFirstLaunch = false;
+    const auto EVENTLOOP = wl_display_get_event_loop(g_pCompositor->m_sWLDisplay);
+
+    m_pReloadTimer = wl_event_loop_add_timer(EVENTLOOP, [](void* data) -> int {
+        ((CConfigManager*)data)->loadConfigLoadVars();
+        return 0;
+    }, this);
+
+    m_pInotifySource = wl_event_loop_add_fd(EVENTLOOP, m_iInotifyFD, WL_EVENT_READABLE, [](int fd, uint32_t mask, void* data) -> int {
+        ((CConfigManager*)data)->onConfigDirEvents();
+        return 0;
+    }, this);
+}
+
+void CConfigManager::onConfigDirEvents() {
+    alignas(inotify_event) char buffer[4096];
+    bool configTouched = false;
+
+    ssize_t len = 0;
+    while ((len = read(m_iInotifyFD, buffer, sizeof(buffer))) > 0) {
+        for (char* ptr = buffer; ptr < buffer + len;) {
+            const auto EVENT = (const inotify_event*)ptr;
+
+            if ((EVENT->mask & IN_Q_OVERFLOW) || (EVENT->len > 0 && m_szConfigFileName == EVENT->name))
+                configTouched = true;
+
+            ptr += sizeof(inotify_event) + EVENT->len;
+        }
+    }
+
+    // editors often save in several steps (truncate, write, rename...), so wait for things to settle.
+    // Every event pushes the reload back.
+    if (configTouched)
+        wl_event_source_timer_update(m_pReloadTimer, CONFIG_RELOAD_DEBOUNCE_MS);
 }
 
 void CConfigManager::configSetValueSafe(const std::string& COMMAND, const std::string& VALUE) {
@@ -97,21 +180,21 @@ void CConfigManager::configSetValueSafe(const std::string& COMMAND, const std::s
             } else
                 CONFIGENTRY.intValue = stol(VALUE);
         } catch (...) {
-            Debug::log(WARN, "Error reading value of %s", COMMAND.c_str());
+            DEBUGLOG(WARN, "Error reading value of %s", COMMAND.c_str());
             parseError = "Error setting value <" + VALUE + "> for field <" + COMMAND + ">.";
         }
     } else if (CONFIGENTRY.floatValue != -1) {
         try {
             CONFIGENTRY.floatValue = stof(VALUE);
         } catch (...) {
-            Debug::log(WARN, "Error reading value of %s", COMMAND.c_str());
+            DEBUGLOG(WARN, "Error reading value of %s", COMMAND.c_str());
             parseError = "Error setting value <" + VALUE + "> for field <" + COMMAND + ">.";
         }
     } else if (CONFIGENTRY.strValue != "") {
         try {
             CONFIGENTRY.strValue = VALUE;
         } catch (...) {
-            Debug::log(WARN, "Error reading value of %s", COMMAND.c_str());
+            DEBUGLOG(WARN, "Error reading value of %s", COMMAND.c_str());
             parseError = "Error setting value <" + VALUE + "> for field <" + COMMAND + ">.";
         }
     }
@@ -220,13 +303,24 @@ void CConfigManager::handleWindowRule(const std::string& command, const std::str
         && RULE.find("size") != 0
         && RULE.find("pseudo") != 0
         && RULE.find("monitor") != 0) {
-            Debug::log(ERR, "Invalid rule found: %s", RULE.c_str());
+            DEBUGLOG(ERR, "Invalid rule found: %s", RULE.c_str());
             parseError = "Invalid rule found: " + RULE;
             return;
         }
 
-    m_dWindowRules.push_back({RULE, VALUE});
+    auto PATTERNIT = m_mWindowRulePatternIDs.find(VALUE);
+
+    if (PATTERNIT == m_mWindowRulePatternIDs.end()) {
+        try {
+            PATTERNIT = m_mWindowRulePatternIDs.emplace(VALUE, m_WindowRuleMatcher.add(VALUE)).first;
+        } catch (std::regex_error& e) {
+            DEBUGLOG(ERR, "Invalid regex in windowrule: %s (%s)", VALUE.c_str(), e.what());
+            parseError = "Invalid regex in windowrule: " + VALUE;
+            return;
+        }
+    }
 
+    m_dWindowRules.push_back({RULE, VALUE, PATTERNIT->second});
 }
 
 void CConfigManager::handleDefaultWorkspace(const std::string& command, const std::string& value) {
@@ -310,15 +404,21 @@ void CConfigManager::parseLine(std::string& line) {
 }
 
 void CConfigManager::loadConfigLoadVars() {
-    Debug::log(LOG, "Reloading the config!");
+    DEBUGLOG(LOG, "Reloading the config!");
     parseError = "";       // reset the error
     currentCategory = "";  // reset the category
-    
+
+    // what we had before, so that only the side effects of what actually changed get applied
+    const auto PREVSNAPSHOT = *m_pCurrentSnapshot;
+
     // reset all vars before loading
     setDefaultVars();
 
     m_dMonitorRules.clear();
     m_dWindowRules.clear();
+    m_WindowRuleMatcher.clear();
+    m_mWindowRulePatternIDs.clear();
+    m_mWindowRuleClassMatches.clear();
     g_pKeybindManager->clearKeybinds();
 
     const char* const ENVHOME = getenv("HOME");
@@ -328,7 +428,7 @@ void CConfigManager::loadConfigLoadVars() {
     ifs.open(CONFIGPATH);
 
     if (!ifs.good()) {
-        Debug::log(WARN, "Config reading error. (No file? Attempting to generate, backing up old one if exists)");
+        DEBUGLOG(WARN, "Config reading error. (No file? Attempting to generate, backing up old one if exists)");
         try {
             std::filesystem::rename(CONFIGPATH, CONFIGPATH + ".backup");
         } catch(...) { /* Probably doesn't exist */}
@@ -356,8 +456,8 @@ void CConfigManager::loadConfigLoadVars() {
             try {
                 parseLine(line);
             } catch (...) {
-                Debug::log(ERR, "Error reading line from config. Line:");
-                Debug::log(NONE, "%s", line.c_str());
+                DEBUGLOG(ERR, "Error reading line from config. Line:");
+                DEBUGLOG(NONE, "%s", line.c_str());
 
                 parseError += "Config error at line " + std::to_string(linenum) + ": Line parsing error.";
             }
@@ -372,12 +472,7 @@ void CConfigManager::loadConfigLoadVars() {
         ifs.close();
     }
 
-    for (auto& m : g_pCompositor->m_lMonitors)
-        g_pLayoutManager->getCurrentLayout()->recalculateMonitor(m.ID);
-
-    // Update the keyboard layout to the cfg'd one if this is not the first launch
-    if (!isFirstLaunch)
-        g_pInputManager->setKeyboardLayout();
+    m_WindowRuleMatcher.compile();
 
     // Calculate the internal vars
     configValues["general:main_mod_internal"].intValue = g_pKeybindManager->stringToModMask(configValues["general:main_mod"].strValue);
@@ -389,6 +484,21 @@ void CConfigManager::loadConfigLoadVars() {
         configValues["general:damage_tracking_internal"].intValue = DAMAGE_TRACKING_NONE;
     }
 
+    const auto BLURMETHOD = configValues["decoration:blur_method"].strValue;
+    if (BLURMETHOD == "gaussian")
+        configValues["decoration:blur_method_internal"].intValue = BLUR_METHOD_GAUSSIAN;
+    else if (BLURMETHOD == "kawase")
+        configValues["decoration:blur_method_internal"].intValue = BLUR_METHOD_KAWASE;
+    else {
+        parseError = "invalid value for decoration:blur_method, supported: gaussian, kawase";
+        configValues["decoration:blur_method_internal"].intValue = BLUR_METHOD_GAUSSIAN;
+    }
+
+    // everything's parsed, make it visible to readers in one go
+    publishSnapshot();
+
+    applyConfigChanges(PREVSNAPSHOT);
+
     // parseError will be displayed next frame
     if (parseError != "")
         g_pHyprError->queueCreate(parseError + "\nHyprland may not work correctly.", CColor(255, 50, 50, 255));
@@ -398,38 +508,82 @@ void CConfigManager::loadConfigLoadVars() {
         g_pHyprError->destroy();
 }
 
-void CConfigManager::tick() {
-    const char* const ENVHOME = getenv("HOME");
+void CConfigManager::applyConfigChanges(const SConfigSnapshot& prev) {
+    const auto& CURRENT = *m_pCurrentSnapshot;
 
-    const std::string CONFIGPATH = ENVHOME + (ISDEBUG ? (std::string) "/.config/hypr/hyprlandd.conf" : (std::string) "/.config/hypr/hyprland.conf");
+    CONFIGCHANGE change = CONFIG_CHANGE_NONE;
+    bool keymap = false;
+    bool blur = false;
 
-    if (!std::filesystem::exists(CONFIGPATH)) {
-        loadConfigLoadVars();
-        return;
+    for (size_t i = 0; i < CURRENT.size(); ++i) {
+        if (CURRENT[i] == prev[i])
+            continue;
+
+        const auto& KEY = m_vSlotKeys[i];
+
+        DEBUGLOG(LOG, "Config: %s changed", KEY.c_str());
+
+        change = std::max(change, configChangeFor(KEY));
+
+        if (KEY.find("input:kb_") == 0)
+            keymap = true;
+
+        if (KEY.find("decoration:blur") == 0)
+            blur = true;
+
+        if (KEY == "debug:log_level")
+            Debug::minLogLevel = CURRENT[i].intValue;
     }
 
-    struct stat fileStat;
-    int err = stat(CONFIGPATH.c_str(), &fileStat);
-    if (err != 0) {
-        Debug::log(WARN, "Error at ticking config at %s, error %i: %s", CONFIGPATH.c_str(), err, strerror(err));
-        return;
+    if (g_pKeybindManager->commitKeybinds())
+        DEBUGLOG(LOG, "Config: keybinds changed");
+
+    // moved windows damage themselves
+    if (change == CONFIG_CHANGE_RELAYOUT) {
+        for (auto& m : g_pCompositor->m_lMonitors)
+            g_pLayoutManager->getCurrentLayout()->recalculateMonitor(m.ID);
     }
 
-    // check if we need to reload cfg
-    if (fileStat.st_mtime != lastModifyTime) {
-        lastModifyTime = fileStat.st_mtime;
+    // there are no keyboards yet on the first launch, they'll pick the layout up when they're added
+    if (keymap && !isFirstLaunch)
+        g_pInputManager->setKeyboardLayout();
+
+    // the cached background blur is stale
+    if (blur && g_pHyprOpenGL) {
+        for (auto& m : g_pCompositor->m_lMonitors)
+            g_pHyprOpenGL->markBlurDirtyForMonitor(&m);
+    }
 
-        loadConfigLoadVars();
+    // colors, rounding, opacity, damage tracking mode... won't show up until something redraws
+    if (change == CONFIG_CHANGE_REPAINT) {
+        for (auto& m : g_pCompositor->m_lMonitors)
+            g_pHyprRenderer->damageMonitor(&m);
     }
 }
 
-std::mutex configmtx;
+CONFIGCHANGE CConfigManager::configChangeFor(const std::string& key) {
+    if (key == "general:border_size" || key == "general:gaps_in" || key == "general:gaps_out" || key == "general:layout")
+        return CONFIG_CHANGE_RELAYOUT;
+
+    // group border colors are only drawn, everything else in there (pseudotile...) changes the tiling
+    if (key.find("dwindle:") == 0)
+        return key.find("dwindle:col.") == 0 ? CONFIG_CHANGE_REPAINT : CONFIG_CHANGE_RELAYOUT;
+
+    if (key.find("general:col.") == 0 || key.find("general:damage_tracking") == 0 || key.find("decoration:") == 0)
+        return CONFIG_CHANGE_REPAINT;
+
+    // input, animations, debug, fps, scanout... are read fresh every time
+    return CONFIG_CHANGE_NONE;
+}
+
 SConfigValue CConfigManager::getConfigValueSafe(std::string val) {
-    std::lock_guard<std::mutex> lg(configmtx);
+    // the slow path, for IPC and such. Hot paths should hold a CConfigHandle.
+    const auto IT = m_mConfigSlots.find(val);
 
-    SConfigValue copy = configValues[val];
+    if (IT == m_mConfigSlots.end())
+        return SConfigValue();
 
-    return copy;
+    return getLiveSnapshot()[IT->second];
 }
 
 int CConfigManager::getInt(std::string v) {
@@ -446,14 +600,17 @@ std::string CConfigManager::getString(std::string v) {
 
 void CConfigManager::setInt(std::string v, int val) {
     configValues[v].intValue = val;
+    publishSnapshot();
 }
 
 void CConfigManager::setFloat(std::string v, float val) {
     configValues[v].floatValue = val;
+    publishSnapshot();
 }
 
 void CConfigManager::setString(std::string v, std::string val) {
     configValues[v].strValue = val;
+    publishSnapshot();
 }
 
 SMonitorRule CConfigManager::getMonitorRuleFor(std::string name) {
@@ -469,7 +626,7 @@ SMonitorRule CConfigManager::getMonitorRuleFor(std::string name) {
     if (found)
         return *found;
 
-    Debug::log(WARN, "No rule found for %s, trying to use the first.", name.c_str());
+    DEBUGLOG(WARN, "No rule found for %s, trying to use the first.", name.c_str());
 
     for (auto& r : m_dMonitorRules) {
         if (r.name == "") {
@@ -481,7 +638,7 @@ SMonitorRule CConfigManager::getMonitorRuleFor(std::string name) {
     if (found)
         return *found;
 
-    Debug::log(WARN, "No rules configured. Using the default hardcoded one.");
+    DEBUGLOG(WARN, "No rules configured. Using the default hardcoded one.");
 
     return SMonitorRule{.name = "", .resolution = Vector2D(1280, 720), .offset = Vector2D(0, 0), .mfact = 0.5f, .scale = 1};
 }
@@ -490,26 +647,32 @@ std::vector<SWindowRule> CConfigManager::getMatchingRules(CWindow* pWindow) {
     if (!g_pCompositor->windowValidMapped(pWindow))
         return std::vector<SWindowRule>();
 
-    std::vector<SWindowRule> returns;
+    const std::string TITLE = g_pXWaylandManager->getTitle(pWindow);
+    const std::string APPIDCLASS = g_pXWaylandManager->getAppIDClass(pWindow);
 
-    std::string title = g_pXWaylandManager->getTitle(pWindow);
-    std::string appidclass = g_pXWaylandManager->getAppIDClass(pWindow);
+    // the same app gets opened over and over, remember what its appid/class matched.
+    // Titles change all the time, caching by them would mostly miss, they go through the matcher every time.
+    auto CLASSIT = m_mWindowRuleClassMatches.find(APPIDCLASS);
 
-    for (auto& rule : m_dWindowRules) {
-        // check if we have a matching rule
-        try {
-            std::regex classCheck(rule.szValue);
+    if (CLASSIT == m_mWindowRuleClassMatches.end()) {
+        std::vector<bool> classMatches;
+        m_WindowRuleMatcher.match(APPIDCLASS, classMatches);
+        CLASSIT = m_mWindowRuleClassMatches.emplace(APPIDCLASS, std::move(classMatches)).first;
+    }
 
-            if (!std::regex_search(title, classCheck) && !std::regex_search(appidclass, classCheck))
-                continue;
-        } catch (...) {
-            Debug::log(ERR, "Regex error at %s", rule.szValue.c_str());
-        }
+    std::vector<bool> titleMatches;
+    m_WindowRuleMatcher.match(TITLE, titleMatches);
+
+    std::vector<SWindowRule> returns;
+
+    for (auto& RULE : m_dWindowRules) {
+        if (!CLASSIT->second[RULE.iPattern] && !titleMatches[RULE.iPattern])
+            continue;
 
         // applies. Read the rule and behave accordingly
-        Debug::log(LOG, "Window rule %s -> %s matched %x [%s]", rule.szRule.c_str(), rule.szValue.c_str(), pWindow, pWindow->m_szTitle.c_str());
+        DEBUGLOG(LOG, "Window rule %s -> %s matched %x [%s]", RULE.szRule.c_str(), RULE.szValue.c_str(), pWindow, pWindow->m_szTitle.c_str());
 
-        returns.push_back(rule);
+        returns.push_back(RULE);
     }
 
     return returns;
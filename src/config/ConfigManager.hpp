@@ -8,14 +8,28 @@
 #include <deque>
 #include <algorithm>
 #include <regex>
+#include <atomic>
+#include <type_traits>
 #include "../Window.hpp"
+#include "../helpers/PatternMatcher.hpp"
 
 #include "defaultConfig.hpp"
 
+#define CONFIG_RELOAD_DEBOUNCE_MS 100
+
+// What has to happen for a changed config value to show up
+enum CONFIGCHANGE {
+    CONFIG_CHANGE_NONE = 0,     // read every time it's used
+    CONFIG_CHANGE_REPAINT,      // drawn with, but nothing redraws on its own
+    CONFIG_CHANGE_RELAYOUT,     // window boxes depend on it
+};
+
 struct SConfigValue {
     int64_t intValue = -1;
     float floatValue = -1;
     std::string strValue = "";
+
+    bool operator==(const SConfigValue&) const = default;
 };
 
 struct SMonitorRule {
@@ -32,13 +46,32 @@ struct SMonitorRule {
 struct SWindowRule {
     std::string szRule;
     std::string szValue;
+    size_t      iPattern = 0;  // into the window rule matcher, rules with the same value share one
+};
+
+// An immutable copy of every config value, indexed by slot. Replaced as a whole on reload.
+typedef std::vector<SConfigValue> SConfigSnapshot;
+
+// A config value resolved once to its slot. Dereferencing it reads the live snapshot:
+// no string hashing, no locking, no copies. Meant to be a function-local static in hot paths, e.g.
+//     static const CConfigHandle<int64_t> ROUNDING("decoration:rounding");
+template <typename T>
+class CConfigHandle {
+    static_assert(std::is_same_v<T, int64_t> || std::is_same_v<T, float> || std::is_same_v<T, std::string>, "Config values are int64_t, float or std::string");
+
+public:
+    explicit CConfigHandle(const std::string&);
+
+    const T&    operator*() const;
+
+private:
+    size_t      m_iSlot = 0;
 };
 
 class CConfigManager {
 public:
     CConfigManager();
 
-    void                tick();
     void                init();
 
     int                 getInt(std::string);
@@ -55,9 +88,24 @@ public:
     // no-op when done.
     void                dispatchExecOnce();
 
+    size_t              getSlot(const std::string&);
+    const SConfigSnapshot& getLiveSnapshot();
+
 private:
     std::unordered_map<std::string, SConfigValue> configValues;
-    time_t lastModifyTime = 0;  // for reloading the config if changed
+
+    // slots are assigned to the keys setDefaultVars knows about, once, in the constructor
+    std::unordered_map<std::string, size_t>     m_mConfigSlots;
+    std::vector<std::string>                    m_vSlotKeys;
+
+    std::atomic<const SConfigSnapshot*>         m_pLiveSnapshot = nullptr;
+    std::unique_ptr<SConfigSnapshot>            m_pCurrentSnapshot;
+    std::unique_ptr<SConfigSnapshot>            m_pRetiredSnapshot; // kept for one more reload in case a reader still holds it
+    // config file watching, all on the main event loop
+    int                 m_iInotifyFD = -1;
+    wl_event_source*    m_pInotifySource = nullptr;
+    wl_event_source*    m_pReloadTimer = nullptr;
+    std::string         m_szConfigFileName = "";
 
     std::string currentCategory = "";  // For storing the category of the current item
 
@@ -67,6 +115,9 @@ private:
 
     std::deque<SMonitorRule> m_dMonitorRules;
     std::deque<SWindowRule> m_dWindowRules;
+    CMultiPatternMatcher m_WindowRuleMatcher; // every distinct windowrule value, compiled when the config is loaded
+    std::unordered_map<std::string, size_t> m_mWindowRulePatternIDs;
+    std::unordered_map<std::string, std::vector<bool>> m_mWindowRuleClassMatches; // appid/class -> which patterns it matches
 
     bool firstExecDispatched = false;
     std::deque<std::string> firstExecRequests;
@@ -75,6 +126,11 @@ private:
     void                setDefaultVars();
 
     void                loadConfigLoadVars();
+    void                startWatchingConfig();
+    void                onConfigDirEvents();
+    void                publishSnapshot();
+    void                applyConfigChanges(const SConfigSnapshot&);
+    CONFIGCHANGE        configChangeFor(const std::string&);
     SConfigValue        getConfigValueSafe(std::string);
     void                parseLine(std::string&);
     void                configSetValueSafe(const std::string&, const std::string&);
@@ -85,4 +141,21 @@ private:
     void                handleDefaultWorkspace(const std::string&, const std::string&);
 };
 
-inline std::unique_ptr<CConfigManager> g_pConfigManager;
\ No newline at end of file
+inline std::unique_ptr<CConfigManager> g_pConfigManager;
+
+template <typename T>
+CConfigHandle<T>::CConfigHandle(const std::string& name) : m_iSlot(g_pConfigManager->getSlot(name)) {
+    ;
+}
+
+template <typename T>
+const T& CConfigHandle<T>::operator*() const {
+    const auto& VALUE = g_pConfigManager->getLiveSnapshot()[m_iSlot];
+
+    if constexpr (std::is_same_v<T, int64_t>)
+        return VALUE.intValue;
+    else if constexpr (std::is_same_v<T, float>)
+        return VALUE.floatValue;
+    else
+        return VALUE.strValue;
+}
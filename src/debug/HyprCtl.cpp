@@ -1,141 +1,497 @@
 #include "HyprCtl.hpp"
 
-#include <netinet/in.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/un.h>
 #include <unistd.h>
 #include <errno.h>
+#include <stdarg.h>
 
 #include <string>
+#include <string_view>
+
+// printf straight onto the end of the reply buffer. The buffer keeps its capacity between requests,
+// so once it's grown this doesn't allocate.
+void appendFormat(std::string& out, const char* fmt, ...) {
+    va_list args, argsCopy;
+    va_start(args, fmt);
+    va_copy(argsCopy, args);
+
+    const int LEN = vsnprintf(nullptr, 0, fmt, args);
+
+    if (LEN > 0) {
+        const auto START = out.length();
+        out.resize(START + LEN + 1);
+        vsnprintf(out.data() + START, LEN + 1, fmt, argsCopy);
+        out.resize(START + LEN);
+    }
+
+    va_end(argsCopy);
+    va_end(args);
+}
+
+void appendJSONString(std::string& out, const std::string& str) {
+    out += '"';
+
+    for (const char c : str) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20)
+                    appendFormat(out, "\\u%04x", (int)c);
+                else
+                    out += c;
+        }
+    }
+
+    out += '"';
+}
+
+void monitorsRequest(std::string& out, bool json) {
+    if (json) {
+        out += '[';
+        for (auto& m : g_pCompositor->m_lMonitors) {
+            if (&m != &g_pCompositor->m_lMonitors.front())
+                out += ',';
+
+            appendFormat(out, "{\"id\":%i,\"name\":", m.ID);
+            appendJSONString(out, m.szName);
+            appendFormat(out, ",\"width\":%i,\"height\":%i,\"refreshRate\":%f,\"x\":%i,\"y\":%i,\"activeWorkspace\":%i,\"reserved\":[%i,%i,%i,%i]}",
+                                (int)m.vecSize.x, (int)m.vecSize.y, m.refreshRate, (int)m.vecPosition.x, (int)m.vecPosition.y, m.activeWorkspace, (int)m.vecReservedTopLeft.x, (int)m.vecReservedTopLeft.y, (int)m.vecReservedBottomRight.x, (int)m.vecReservedBottomRight.y);
+        }
+        out += ']';
+        return;
+    }
 
-std::string monitorsRequest() {
-    std::string result = "";
     for (auto& m : g_pCompositor->m_lMonitors) {
-        result += getFormat("Monitor %s (ID %i):\n\t%ix%i@%f at %ix%i\n\tactive workspace: %i\n\treserved: %i %i %i %i\n\n",
+        appendFormat(out, "Monitor %s (ID %i):\n\t%ix%i@%f at %ix%i\n\tactive workspace: %i\n\treserved: %i %i %i %i\n\n",
                             m.szName.c_str(), m.ID, (int)m.vecSize.x, (int)m.vecSize.y, m.refreshRate, (int)m.vecPosition.x, (int)m.vecPosition.y, m.activeWorkspace, (int)m.vecReservedTopLeft.x, (int)m.vecReservedTopLeft.y, (int)m.vecReservedBottomRight.x, (int)m.vecReservedBottomRight.y);
     }
+}
 
-    return result;
+void windowJSON(std::string& out, CWindow* pWindow) {
+    appendFormat(out, "{\"address\":\"%lx\",\"title\":", (uintptr_t)pWindow);
+    appendJSONString(out, pWindow->m_szTitle);
+    appendFormat(out, ",\"at\":[%i,%i],\"size\":[%i,%i],\"workspace\":%i,\"floating\":%s}",
+                        (int)pWindow->m_vRealPosition.x, (int)pWindow->m_vRealPosition.y, (int)pWindow->m_vRealSize.x, (int)pWindow->m_vRealSize.y, pWindow->m_iWorkspaceID, pWindow->m_bIsFloating ? "true" : "false");
 }
 
-std::string clientsRequest() {
-    std::string result = "";
+void clientsRequest(std::string& out, bool json) {
+    if (json) {
+        out += '[';
+        for (auto& w : g_pCompositor->m_lWindows) {
+            if (&w != &g_pCompositor->m_lWindows.front())
+                out += ',';
+
+            windowJSON(out, &w);
+        }
+        out += ']';
+        return;
+    }
+
     for (auto& w : g_pCompositor->m_lWindows) {
-        result += getFormat("Window %x -> %s:\n\tat: %i,%i\n\tsize: %i, %i\n\tworkspace: %i\n\tfloating: %i\n\n",
-                            &w, w.m_szTitle.c_str(), (int)w.m_vRealPosition.x, (int)w.m_vRealPosition.y, (int)w.m_vRealSize.x, (int)w.m_vRealSize.y, w.m_iWorkspaceID, (int)w.m_bIsFloating);
+        appendFormat(out, "Window %lx -> %s:\n\tat: %i,%i\n\tsize: %i, %i\n\tworkspace: %i\n\tfloating: %i\n\n",
+                            (uintptr_t)&w, w.m_szTitle.c_str(), (int)w.m_vRealPosition.x, (int)w.m_vRealPosition.y, (int)w.m_vRealSize.x, (int)w.m_vRealSize.y, w.m_iWorkspaceID, (int)w.m_bIsFloating);
     }
-    return result;
 }
 
-std::string workspacesRequest() {
-    std::string result = "";
+void workspacesRequest(std::string& out, bool json) {
+    if (json) {
+        out += '[';
+        for (auto& w : g_pCompositor->m_lWorkspaces) {
+            if (&w != &g_pCompositor->m_lWorkspaces.front())
+                out += ',';
+
+            appendFormat(out, "{\"id\":%i,\"monitor\":", w.m_iID);
+            appendJSONString(out, g_pCompositor->getMonitorFromID(w.m_iMonitorID)->szName);
+            appendFormat(out, ",\"windows\":%i,\"hasfullscreen\":%s}", g_pCompositor->getWindowsOnWorkspace(w.m_iID), w.m_bHasFullscreenWindow ? "true" : "false");
+        }
+        out += ']';
+        return;
+    }
+
     for (auto& w : g_pCompositor->m_lWorkspaces) {
-        result += getFormat("workspace ID %i on monitor %s:\n\twindows: %i\n\thasfullscreen: %i\n\n",
+        appendFormat(out, "workspace ID %i on monitor %s:\n\twindows: %i\n\thasfullscreen: %i\n\n",
                             w.m_iID, g_pCompositor->getMonitorFromID(w.m_iMonitorID)->szName.c_str(), g_pCompositor->getWindowsOnWorkspace(w.m_iID), (int)w.m_bHasFullscreenWindow);
     }
-    return result;
 }
 
-std::string activeWindowRequest() {
-    const auto PWINDOW = g_pCompositor->m_pLastWindow;
+void activeWindowRequest(std::string& out, bool json) {
+    const auto PWINDOW = g_pCompositor->m_pLastWindow.get();
+
+    if (!g_pCompositor->windowValidMapped(PWINDOW)) {
+        out += json ? "{}" : "Invalid";
+        return;
+    }
 
-    if (!g_pCompositor->windowValidMapped(PWINDOW))
-        return "Invalid";
+    if (json) {
+        windowJSON(out, PWINDOW);
+        return;
+    }
 
-    return getFormat("Window %x -> %s:\n\tat: %i,%i\n\tsize: %i, %i\n\tworkspace: %i\n\tfloating: %i\n\n",
-                        PWINDOW, PWINDOW->m_szTitle.c_str(), (int)PWINDOW->m_vRealPosition.x, (int)PWINDOW->m_vRealPosition.y, (int)PWINDOW->m_vRealSize.x, (int)PWINDOW->m_vRealSize.y, PWINDOW->m_iWorkspaceID, (int)PWINDOW->m_bIsFloating);
+    appendFormat(out, "Window %lx -> %s:\n\tat: %i,%i\n\tsize: %i, %i\n\tworkspace: %i\n\tfloating: %i\n\n",
+                        (uintptr_t)PWINDOW, PWINDOW->m_szTitle.c_str(), (int)PWINDOW->m_vRealPosition.x, (int)PWINDOW->m_vRealPosition.y, (int)PWINDOW->m_vRealSize.x, (int)PWINDOW->m_vRealSize.y, PWINDOW->m_iWorkspaceID, (int)PWINDOW->m_bIsFloating);
 }
 
-std::string layersRequest() {
-    std::string result = "";
+void layersRequest(std::string& out, bool json) {
+    if (json) {
+        out += '[';
+        for (auto& mon : g_pCompositor->m_lMonitors) {
+            if (&mon != &g_pCompositor->m_lMonitors.front())
+                out += ',';
+
+            out += "{\"monitor\":";
+            appendJSONString(out, mon.szName);
+            out += ",\"levels\":[";
+
+            for (auto& level : mon.m_aLayerSurfaceLists) {
+                if (&level != &mon.m_aLayerSurfaceLists.front())
+                    out += ',';
+
+                out += '[';
+                for (auto& layer : level) {
+                    if (layer != level.front())
+                        out += ',';
+
+                    appendFormat(out, "{\"address\":\"%lx\",\"x\":%i,\"y\":%i,\"w\":%i,\"h\":%i}", (uintptr_t)layer, layer->geometry.x, layer->geometry.y, layer->geometry.width, layer->geometry.height);
+                }
+                out += ']';
+            }
+
+            out += "]}";
+        }
+        out += ']';
+        return;
+    }
 
     for (auto& mon : g_pCompositor->m_lMonitors) {
-        result += getFormat("Monitor %s:\n");
+        appendFormat(out, "Monitor %s:\n", mon.szName.c_str());
         int layerLevel = 0;
         for (auto& level : mon.m_aLayerSurfaceLists) {
-            result += getFormat("\tLayer level %i:\n", layerLevel);
+            appendFormat(out, "\tLayer level %i:\n", layerLevel);
 
             for (auto& layer : level) {
-                result += getFormat("\t\tLayer %x: xywh: %i %i %i %i\n", layer, layer->geometry.x, layer->geometry.y, layer->geometry.width, layer->geometry.height);
+                appendFormat(out, "\t\tLayer %lx: xywh: %i %i %i %i\n", (uintptr_t)layer, layer->geometry.x, layer->geometry.y, layer->geometry.width, layer->geometry.height);
             }
 
             layerLevel++;
         }
-        result += "\n\n";
+        out += "\n\n";
+    }
+}
+
+void glStatsRequest(std::string& out, bool json) {
+    const auto& STATS = g_pHyprOpenGL->m_sGLStateStats;
+
+    bool first = true;
+    const auto addCounter = [&](const char* name, const SGLCallCounter& counter) {
+        if (json)
+            appendFormat(out, "%s\"%s\":{\"issued\":%llu,\"avoided\":%llu}", first ? "" : ",", name, (unsigned long long)counter.issued, (unsigned long long)counter.avoided);
+        else
+            appendFormat(out, "%s: issued %llu, avoided %llu\n", name, (unsigned long long)counter.issued, (unsigned long long)counter.avoided);
+
+        first = false;
+    };
+
+    if (json)
+        out += '{';
+
+    addCounter("glUseProgram", STATS.useProgram);
+    addCounter("glEnable/glDisable(GL_BLEND)", STATS.blend);
+    addCounter("glActiveTexture", STATS.activeTexture);
+    addCounter("glTexParameteri", STATS.texParameter);
+
+    if (json)
+        out += '}';
+}
+
+// plain replies like "ok" still have to be valid JSON when JSON was asked for
+void appendMessage(std::string& out, const std::string& message, bool json) {
+    if (json)
+        appendJSONString(out, message);
+    else
+        out += message;
+}
+
+void dispatchRequest(std::string& out, std::string_view request, bool json) {
+    // dispatch <dispatcher> <args>, same as a bind would call it
+    const auto SPACE = request.find(' ');
+    const std::string DISPATCHER(request.substr(0, SPACE));
+    const std::string ARGS(SPACE == std::string_view::npos ? "" : request.substr(SPACE + 1));
+
+    if (!g_pKeybindManager->invokeDispatcher(DISPATCHER, ARGS)) {
+        appendMessage(out, "Invalid dispatcher", json);
+        return;
     }
 
-    return result;
+    appendMessage(out, "ok", json);
 }
 
-void HyprCtl::startHyprCtlSocket() {
-    std::thread([&]() {
-        uint16_t connectPort = 9187;
+// "j/" in front of a request asks for JSON
+void handleRequest(std::string& out, std::string_view request) {
+    const bool JSON = request.starts_with("j/");
+
+    if (JSON)
+        request.remove_prefix(2);
+
+    if (request == "monitors") monitorsRequest(out, JSON);
+    else if (request == "workspaces") workspacesRequest(out, JSON);
+    else if (request == "clients") clientsRequest(out, JSON);
+    else if (request == "activewindow") activeWindowRequest(out, JSON);
+    else if (request == "layers") layersRequest(out, JSON);
+    else if (request == "glstats") glStatsRequest(out, JSON);
+    else if (request.starts_with("dispatch ")) dispatchRequest(out, request.substr(9), JSON);
+    else appendMessage(out, "unknown request", JSON);
+}
 
-        const auto SOCKET = socket(AF_INET, SOCK_STREAM, 0);
+// the next ';' that isn't inside quotes, so e.g. dispatch exec sh -c "a; b" stays in one piece
+size_t findBatchSeparator(std::string_view request) {
+    char quote = 0;
 
-        if (SOCKET < 0) {
-            Debug::log(ERR, "Couldn't start the Hyprland Socket. (1) IPC will not work.");
-            return;
+    for (size_t i = 0; i < request.length(); ++i) {
+        const char C = request[i];
+
+        if (quote) {
+            if (C == quote)
+                quote = 0;
+        } else if (C == '"' || C == '\'') {
+            quote = C;
+        } else if (C == ';') {
+            return i;
         }
+    }
+
+    return std::string_view::npos;
+}
+
+void getReply(std::string& out, std::string_view request) {
+    // j/[[BATCH]] makes every item a j/ request and the reply one JSON array
+    const bool JSONBATCH = request.starts_with("j/[[BATCH]]");
+
+    if (JSONBATCH)
+        request.remove_prefix(2);
+
+    if (!request.starts_with("[[BATCH]]")) {
+        handleRequest(out, request);
+        return;
+    }
+
+    // [[BATCH]]req1;req2;... runs everything in one go, nothing else happens in between.
+    // Replies come back in order, each followed by an empty line. Quotes are left in the request as they are.
+    request.remove_prefix(9);
+
+    if (JSONBATCH)
+        out += '[';
+
+    bool first = true;
+
+    while (!request.empty()) {
+        const auto SEPARATOR = findBatchSeparator(request);
+        auto single = request.substr(0, SEPARATOR);
+
+        while (!single.empty() && single.front() == ' ')
+            single.remove_prefix(1);
+        while (!single.empty() && single.back() == ' ')
+            single.remove_suffix(1);
 
-        sockaddr_in SERVERADDRESS = {.sin_family = AF_INET, .sin_port = connectPort, .sin_addr = (in_addr)INADDR_ANY};
+        if (!single.empty()) {
+            if (JSONBATCH) {
+                if (!first)
+                    out += ',';
 
-        while(connectPort < 11000) {
-            if (bind(SOCKET, (sockaddr*)&SERVERADDRESS, sizeof(SERVERADDRESS)) < 0) {
-                Debug::log(LOG, "IPC: Port %d failed with an error: %s", connectPort, strerror(errno));
+                if (single.starts_with("j/"))
+                    single.remove_prefix(2);
+
+                handleRequest(out, "j/" + std::string(single));
             } else {
-                break;
+                handleRequest(out, single);
+                out += "\n\n";
             }
 
-            connectPort++;
-            SERVERADDRESS.sin_port = connectPort;
+            first = false;
         }
-        
 
-        // 10 max queued.
-        listen(SOCKET, 10);
+        if (SEPARATOR == std::string_view::npos)
+            break;
 
-        sockaddr_in clientAddress;
-        socklen_t clientSize = sizeof(clientAddress);
+        request.remove_prefix(SEPARATOR + 1);
+    }
 
-        char readBuffer[1024] = {0};
+    if (JSONBATCH)
+        out += ']';
+}
 
-        Debug::log(LOG, "Hypr socket started on port %i", connectPort);
+void closeHyprCtlClient(SHyprCtlClient* pClient) {
+    wl_event_source_remove(pClient->eventSource);
+    close(pClient->fd);
 
-        std::string cmd = "rm -f /tmp/hypr/.socket";
-        system(cmd.c_str()); // forgive me for using system() but it works and it doesnt matter here that much
-        cmd = "echo \"" + std::to_string(connectPort) + "\" > /tmp/hypr/.socket";
-        system(cmd.c_str());
+    HyprCtl::clients.remove_if([&](const SHyprCtlClient& other) { return &other == pClient; });
+}
 
-        while(1) {
-            const auto ACCEPTEDCONNECTION = accept(SOCKET, (sockaddr*)&clientAddress, &clientSize);
+// false if the client had to be closed
+bool flushHyprCtlClient(SHyprCtlClient* pClient) {
+    const size_t TOTAL = sizeof(pClient->replyLength) + pClient->reply.length();
 
-            if (ACCEPTEDCONNECTION < 0) {
-                Debug::log(ERR, "Couldn't listen on the Hyprland Socket. (3) IPC will not work.");
-                break;
-            }
+    while (pClient->written < TOTAL) {
+        iovec iov[2];
+        int iovcnt = 0;
+
+        // header and reply go out in one syscall, no copying them together first
+        if (pClient->written < sizeof(pClient->replyLength))
+            iov[iovcnt++] = {(char*)&pClient->replyLength + pClient->written, sizeof(pClient->replyLength) - pClient->written};
+
+        const size_t REPLYOFFSET = pClient->written < sizeof(pClient->replyLength) ? 0 : pClient->written - sizeof(pClient->replyLength);
+        iov[iovcnt++] = {pClient->reply.data() + REPLYOFFSET, pClient->reply.length() - REPLYOFFSET};
+
+        msghdr msg = {.msg_iov = iov, .msg_iovlen = (size_t)iovcnt};
+        const auto WRITTEN = sendmsg(pClient->fd, &msg, MSG_NOSIGNAL);
+
+        if (WRITTEN < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return true;
+
+            closeHyprCtlClient(pClient);
+            return false;
+        }
+
+        pClient->written += WRITTEN;
+    }
+
+    return true;
+}
+
+void processHyprCtlRequests(SHyprCtlClient* pClient) {
+    size_t consumed = 0;
+
+    while (!pClient->bWriting && pClient->request.length() - consumed >= sizeof(uint32_t)) {
+        uint32_t length = 0;
+        memcpy(&length, pClient->request.data() + consumed, sizeof(length));
+
+        if (length > HYPRCTL_MAX_REQUEST) {
+            DEBUGLOG(ERR, "IPC: request of %u bytes is too big, closing the connection", length);
+            closeHyprCtlClient(pClient);
+            return;
+        }
+
+        if (pClient->request.length() - consumed - sizeof(length) < length)
+            break;  // not all here yet
 
-            auto messageSize = read(ACCEPTEDCONNECTION, readBuffer, 1024);
-            readBuffer[messageSize == 1024 ? 1024 : messageSize] = '\0';
+        const std::string_view REQUEST(pClient->request.data() + consumed + sizeof(length), length);
+        consumed += sizeof(length) + length;
 
-            std::string request(readBuffer);
+        pClient->reply.clear();
+        getReply(pClient->reply, REQUEST);
+        pClient->replyLength = pClient->reply.length();
+        pClient->written = 0;
 
-            std::string reply = "";
-            if (request == "monitors") reply = monitorsRequest();
-            if (request == "workspaces") reply = workspacesRequest();
-            if (request == "clients") reply = clientsRequest();
-            if (request == "activewindow") reply = activeWindowRequest();
-            if (request == "layers") reply = layersRequest();
+        if (!flushHyprCtlClient(pClient))
+            return;
+
+        if (pClient->written < sizeof(pClient->replyLength) + pClient->reply.length()) {
+            // the rest is written whenever the client drains its end. Further requests wait until then.
+            pClient->bWriting = true;
+            wl_event_source_fd_update(pClient->eventSource, WL_EVENT_WRITABLE);
+        }
+    }
+
+    pClient->request.erase(0, consumed);
+
+    // they're done sending and we're done answering
+    if (pClient->bHungUp && !pClient->bWriting)
+        closeHyprCtlClient(pClient);
+}
 
-            write(ACCEPTEDCONNECTION, reply.c_str(), reply.length());
+int hyprCtlClientEvent(int fd, uint32_t mask, void* data) {
+    const auto PCLIENT = (SHyprCtlClient*)data;
 
+    if (mask & WL_EVENT_WRITABLE) {
+        if (!flushHyprCtlClient(PCLIENT))
+            return 0;
+
+        if (PCLIENT->written < sizeof(PCLIENT->replyLength) + PCLIENT->reply.length())
+            return 0;
+
+        PCLIENT->bWriting = false;
+        wl_event_source_fd_update(PCLIENT->eventSource, WL_EVENT_READABLE);
+    } else if (mask & WL_EVENT_READABLE) {
+        char readBuffer[4096];
+        ssize_t len = 0;
+
+        while ((len = read(fd, readBuffer, sizeof(readBuffer))) > 0)
+            PCLIENT->request.append(readBuffer, len);
+
+        if (len == 0)
+            PCLIENT->bHungUp = true;  // might still want the replies to what they sent
+        else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            closeHyprCtlClient(PCLIENT);
+            return 0;
+        }
+    } else if (mask & (WL_EVENT_HANGUP | WL_EVENT_ERROR)) {
+        closeHyprCtlClient(PCLIENT);
+        return 0;
+    }
+
+    processHyprCtlRequests(PCLIENT);
+    return 0;
+}
+
+int hyprCtlSocketEvent(int fd, uint32_t mask, void* data) {
+    while (true) {
+        const auto ACCEPTEDCONNECTION = accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (ACCEPTEDCONNECTION < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                DEBUGLOG(ERR, "IPC: accept failed: %s", strerror(errno));
+            break;
+        }
+
+        if (HyprCtl::clients.size() >= HYPRCTL_MAX_CLIENTS) {
+            DEBUGLOG(WARN, "IPC: too many clients, dropping a connection");
             close(ACCEPTEDCONNECTION);
+            continue;
         }
 
-        close(SOCKET);
-    }).detach();
-}
\ No newline at end of file
+        auto& client = HyprCtl::clients.emplace_back();
+        client.fd = ACCEPTEDCONNECTION;
+        client.eventSource = wl_event_loop_add_fd(wl_display_get_event_loop(g_pCompositor->m_sWLDisplay), ACCEPTEDCONNECTION, WL_EVENT_READABLE, hyprCtlClientEvent, &client);
+    }
+
+    return 0;
+}
+
+void HyprCtl::startHyprCtlSocket() {
+    iSocketFD = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (iSocketFD < 0) {
+        DEBUGLOG(ERR, "Couldn't start the Hyprland Socket. (1) IPC will not work.");
+        return;
+    }
+
+    sockaddr_un SERVERADDRESS = {.sun_family = AF_UNIX};
+    strcpy(SERVERADDRESS.sun_path, HYPRCTL_SOCKET_PATH);
+
+    // a previous instance might've left it behind
+    unlink(HYPRCTL_SOCKET_PATH);
+
+    if (bind(iSocketFD, (sockaddr*)&SERVERADDRESS, SUN_LEN(&SERVERADDRESS)) < 0) {
+        DEBUGLOG(ERR, "Couldn't bind the Hyprland Socket (%s). (2) IPC will not work.", strerror(errno));
+        close(iSocketFD);
+        iSocketFD = -1;
+        return;
+    }
+
+    // 10 max queued.
+    listen(iSocketFD, 10);
+
+    pSocketSource = wl_event_loop_add_fd(wl_display_get_event_loop(g_pCompositor->m_sWLDisplay), iSocketFD, WL_EVENT_READABLE, hyprCtlSocketEvent, nullptr);
+
+    DEBUGLOG(LOG, "Hypr socket started at %s", HYPRCTL_SOCKET_PATH);
+}
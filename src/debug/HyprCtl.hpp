@@ -3,10 +3,30 @@
 #include "../Compositor.hpp"
 #include <fstream>
 #include "../helpers/MiscFunctions.hpp"
+#include <list>
+
+#define HYPRCTL_SOCKET_PATH "/tmp/hypr/.socket.sock"
+#define HYPRCTL_MAX_CLIENTS 64
+#define HYPRCTL_MAX_REQUEST 65536
+
+// A connected IPC client. Both ways, messages are framed as a native-endian uint32_t length
+// followed by that many bytes. A client can send as many requests as it likes on one connection.
+struct SHyprCtlClient {
+    int                 fd = -1;
+    wl_event_source*    eventSource = nullptr;
+    std::string         request = "";   // read but not handled yet
+    std::string         reply = "";     // reused between requests, keeps its capacity
+    uint32_t            replyLength = 0;
+    size_t              written = 0;    // of the header + reply
+    bool                bWriting = false;
+    bool                bHungUp = false;
+};
 
 namespace HyprCtl {
     void            startHyprCtlSocket();
     void            tickHyprCtl();
 
-    inline std::ifstream requestStream;
+    inline int      iSocketFD = -1;
+    inline wl_event_source* pSocketSource = nullptr;
+    inline std::list<SHyprCtlClient> clients;
 };
\ No newline at end of file
@@ -1,45 +1,239 @@
 #include "Log.hpp"
 #include "../defines.hpp"
 
-#include <fstream>
-#include <iostream>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <unistd.h>
 
-void Debug::log(LogLevel level, const char* fmt, ...) {
-    va_list args;
-    va_start(args, fmt);
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
-    // log to a file
-    const std::string DEBUGPATH = ISDEBUG ? "/tmp/hypr/hyprlandd.log" : "/tmp/hypr/hyprland.log";
-    std::ofstream ofs;
-    ofs.open(DEBUGPATH, std::ios::out | std::ios::app);
+struct SLogEntry {
+    LogLevel    level = LOG;
+    int         length = 0;
+    char        message[LOGMESSAGESIZE];
+};
+
+// Single producer (its thread), single consumer (whoever holds flushMutex)
+struct SLogRing {
+    std::array<SLogEntry, LOGRINGSLOTS> entries;
+    std::atomic<size_t>                 head = 0;  // next to write
+    std::atomic<size_t>                 tail = 0;  // next to read
+    std::atomic<size_t>                 dropped = 0;
+    std::atomic<bool>                   threadExited = false; // nothing more gets written, free it once it's drained
+};
+
+// Owns the calling thread's ring, marks it for removal when the thread exits
+struct SLogRingOwner {
+    std::shared_ptr<SLogRing> ring;
+
+    ~SLogRingOwner() {
+        if (ring)
+            ring->threadExited.store(true, std::memory_order_release);
+    }
+};
+
+static std::mutex                              ringsMutex;  // only guards the list, never held while writing
+static std::vector<std::shared_ptr<SLogRing>>  logRings;
+static std::mutex                              flushMutex;
+static std::atomic<uint32_t>                   wakeWriter = 0;
+static std::atomic<bool>                       stopWriter = false;
+static std::thread                             writerThread;
+static int                                     logFD = -1;
+static std::string                             fileBuffer = "";
+static std::string                             stdoutBuffer = "";
+
+static SLogRing* getThreadRing() {
+    thread_local SLogRingOwner owner;
 
+    if (!owner.ring) {
+        owner.ring = std::make_shared<SLogRing>();
+
+        std::lock_guard<std::mutex> lg(ringsMutex);
+        logRings.push_back(owner.ring);
+    }
+
+    return owner.ring.get();
+}
+
+static const char* levelPrefix(LogLevel level) {
     switch (level) {
-        case LOG:
-            ofs << "[LOG] ";
-            break;
-        case WARN:
-            ofs << "[WARN] ";
-            break;
-        case ERR:
-            ofs << "[ERR] ";
-            break;
-        case CRIT:
-            ofs << "[CRITICAL] ";
-            break;
-        default:
-            break;
+        case LOG: return "[LOG] ";
+        case WARN: return "[WARN] ";
+        case ERR: return "[ERR] ";
+        case CRIT: return "[CRITICAL] ";
+        default: return "";
+    }
+}
+
+static void writeAll(int fd, const std::string& data) {
+    size_t written = 0;
+
+    while (written < data.length()) {
+        const auto LEN = write(fd, data.c_str() + written, data.length() - written);
+
+        if (LEN <= 0)
+            return;
+
+        written += LEN;
     }
+}
 
-    char buf[LOGMESSAGESIZE] = "";
+static void appendEntry(LogLevel level, const char* message, int length) {
+    fileBuffer += levelPrefix(level);
+    fileBuffer.append(message, length);
+    fileBuffer += '\n';
 
-    vsprintf(buf, fmt, args);
+    // stdout gets it without the level, as it always has
+    stdoutBuffer.append(message, length);
+    stdoutBuffer += '\n';
+}
 
-    ofs << buf << "\n";
+static void writeBuffers() {
+    if (logFD >= 0)
+        writeAll(logFD, fileBuffer);
 
-    ofs.close();
+    writeAll(STDOUT_FILENO, stdoutBuffer);
+
+    fileBuffer.clear();
+    stdoutBuffer.clear();
+}
+
+// flushMutex has to be held
+static void drainRings() {
+    // a copy, so that a thread logging for the first time doesn't wait on the writes below
+    std::vector<std::shared_ptr<SLogRing>> rings;
+    {
+        std::lock_guard<std::mutex> lg(ringsMutex);
+        rings = logRings;
+    }
 
-    // log it to the stdout too.
-    std::cout << buf << "\n";
+    bool exitedRings = false;
+
+    for (auto& ring : rings) {
+        // checked before draining: once it's set, what we drain below is everything the thread wrote
+        const bool EXITED = ring->threadExited.load(std::memory_order_acquire);
+        exitedRings = exitedRings || EXITED;
+
+        auto       tail = ring->tail.load(std::memory_order_relaxed);
+        const auto HEAD = ring->head.load(std::memory_order_acquire);
+
+        for (; tail != HEAD; ++tail) {
+            const auto& ENTRY = ring->entries[tail % LOGRINGSLOTS];
+            appendEntry(ENTRY.level, ENTRY.message, ENTRY.length);
+        }
+
+        ring->tail.store(tail, std::memory_order_release);
+
+        // whatever got dropped came after what we just wrote
+        const auto DROPPED = ring->dropped.exchange(0, std::memory_order_relaxed);
+
+        if (DROPPED > 0) {
+            const auto MSG = "Log ring full, dropped " + std::to_string(DROPPED) + " messages";
+            appendEntry(WARN, MSG.c_str(), MSG.length());
+        }
+
+        if (!EXITED)
+            ring.reset();
+    }
 
+    writeBuffers();
+
+    if (!exitedRings)
+        return;
+
+    // the ones still held in the copy are the drained rings of exited threads
+    std::lock_guard<std::mutex> lg(ringsMutex);
+    std::erase_if(logRings, [&](const auto& ring) { return std::find(rings.begin(), rings.end(), ring) != rings.end(); });
+}
+
+void Debug::init() {
+    const std::string DEBUGPATH = ISDEBUG ? "/tmp/hypr/hyprlandd.log" : "/tmp/hypr/hyprland.log";
+
+    logFD = open(DEBUGPATH.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+
+    writerThread = std::thread([]() {
+        while (!stopWriter.load(std::memory_order_acquire)) {
+            const auto SEEN = wakeWriter.load(std::memory_order_acquire);
+
+            {
+                std::lock_guard<std::mutex> lg(flushMutex);
+                drainRings();
+            }
+
+            wakeWriter.wait(SEEN, std::memory_order_acquire);
+
+            if (stopWriter.load(std::memory_order_acquire))
+                break;
+
+            // let a burst pile up, it's one write for all of it then. Nobody's waiting on the atomic
+            // in the meantime, so logging doesn't even cost a futex wake.
+            std::this_thread::sleep_for(std::chrono::milliseconds(LOGFLUSHINTERVALMS));
+        }
+    });
+}
+
+void Debug::flush() {
+    std::lock_guard<std::mutex> lg(flushMutex);
+    drainRings();
+}
+
+void Debug::close() {
+    if (writerThread.joinable()) {
+        stopWriter.store(true, std::memory_order_release);
+        wakeWriter.fetch_add(1, std::memory_order_release);
+        wakeWriter.notify_one();
+        writerThread.join();
+    }
+
+    flush();
+
+    if (logFD >= 0) {
+        ::close(logFD);
+        logFD = -1;
+    }
+}
+
+void Debug::logImpl(LogLevel level, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+
+    if (level == CRIT) {
+        // we're likely about to die, get everything out now
+        char buf[LOGMESSAGESIZE] = "";
+        const int LEN = vsnprintf(buf, LOGMESSAGESIZE, fmt, args);
+        va_end(args);
+
+        std::lock_guard<std::mutex> lg(flushMutex);
+        drainRings();
+        appendEntry(level, buf, std::clamp(LEN, 0, LOGMESSAGESIZE - 1));
+        writeBuffers();
+        return;
+    }
+
+    const auto RING = getThreadRing();
+    const auto HEAD = RING->head.load(std::memory_order_relaxed);
+
+    if (HEAD - RING->tail.load(std::memory_order_acquire) >= LOGRINGSLOTS) {
+        va_end(args);
+        RING->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto& entry = RING->entries[HEAD % LOGRINGSLOTS];
+    const int LEN = vsnprintf(entry.message, LOGMESSAGESIZE, fmt, args);
     va_end(args);
+
+    entry.level = level;
+    entry.length = std::clamp(LEN, 0, LOGMESSAGESIZE - 1);
+
+    RING->head.store(HEAD + 1, std::memory_order_release);
+
+    wakeWriter.fetch_add(1, std::memory_order_release);
+    wakeWriter.notify_one();
 }
@@ -1,7 +1,10 @@
 #pragma once
 #include <string>
+#include <atomic>
 
 #define LOGMESSAGESIZE 1024
+#define LOGRINGSLOTS 1024       // per logging thread. When it's full, messages are dropped (and counted), never waited on.
+#define LOGFLUSHINTERVALMS 5    // the writer lets messages pile up this long before writing them out
 
 enum LogLevel {
     NONE = -1,
@@ -11,6 +14,37 @@ enum LogLevel {
     CRIT
 };
 
+// Anything below this is compiled out entirely. Build with e.g. -DHYPRLAND_MIN_LOG_LEVEL=WARN
+#ifndef HYPRLAND_MIN_LOG_LEVEL
+#define HYPRLAND_MIN_LOG_LEVEL LOG
+#endif
+
 namespace Debug {
-    void log(LogLevel level, const char* fmt, ...);
-};
\ No newline at end of file
+    // opens the log file and starts the writer. Messages from before that wait in the ring.
+    void init();
+    // writes out everything pending, synchronously
+    void flush();
+    // stops the writer and writes out what's left. Call it last, nothing logged after it gets written.
+    void close();
+
+    inline std::atomic<int> minLogLevel = LOG;  // debug:log_level
+
+    // Formats into the calling thread's ring, a background thread writes it out. CRIT is written out before returning.
+    // Use DEBUGLOG, not this.
+    void logImpl(LogLevel level, const char* fmt, ...);
+
+    // The levels are literals at every call site, so the first half folds away at compile time
+    constexpr bool enabled(LogLevel level, int minLevel) {
+        const int EFFECTIVELEVEL = level == NONE ? LOG : level;  // NONE is an unprefixed LOG
+
+        return EFFECTIVELEVEL >= HYPRLAND_MIN_LOG_LEVEL && EFFECTIVELEVEL >= minLevel;
+    }
+};
+
+// A macro so that the level is checked before the arguments are evaluated:
+// a filtered out message costs a compare, one below HYPRLAND_MIN_LOG_LEVEL nothing at all.
+#define DEBUGLOG(level, fmt, ...)                                                                      \
+    do {                                                                                               \
+        if (Debug::enabled(level, Debug::minLogLevel.load(std::memory_order_relaxed)))                 \
+            Debug::logImpl(level, fmt, ##__VA_ARGS__);                                                 \
+    } while (0)
@@ -19,7 +19,7 @@ void Events::listener_keyboardDestroy(void* owner, void* data) {
     SKeyboard* PKEYBOARD = (SKeyboard*)owner;
     g_pInputManager->destroyKeyboard(PKEYBOARD);
 
-    Debug::log(LOG, "Destroyed keyboard %x", PKEYBOARD);
+    DEBUGLOG(LOG, "Destroyed keyboard %x", PKEYBOARD);
 }
 
 void Events::listener_keyboardKey(void* owner, void* data) {
@@ -66,11 +66,11 @@ void Events::listener_newInput(wl_listener* listener, void* data) {
 
     switch(DEVICE->type) {
         case WLR_INPUT_DEVICE_KEYBOARD:
-            Debug::log(LOG, "Attached a keyboard with name %s", DEVICE->name);
+            DEBUGLOG(LOG, "Attached a keyboard with name %s", DEVICE->name);
             g_pInputManager->newKeyboard(DEVICE);
             break;
         case WLR_INPUT_DEVICE_POINTER:
-            Debug::log(LOG, "Attached a mouse with name %s", DEVICE->name);
+            DEBUGLOG(LOG, "Attached a mouse with name %s", DEVICE->name);
             g_pInputManager->newMouse(DEVICE);
             break;
         default:
@@ -85,7 +85,7 @@ void Events::listener_newInput(wl_listener* listener, void* data) {
 void Events::listener_newConstraint(wl_listener* listener, void* data) {
     const auto PCONSTRAINT = (wlr_pointer_constraint_v1*)data;
 
-    Debug::log(LOG, "New mouse constraint at %x", PCONSTRAINT);
+    DEBUGLOG(LOG, "New mouse constraint at %x", PCONSTRAINT);
 
     g_pInputManager->m_lConstraints.emplace_back();
     const auto CONSTRAINT = &g_pInputManager->m_lConstraints.back();
@@ -109,7 +109,7 @@ void Events::listener_destroyConstraint(void* owner, void* data) {
         PCONSTRAINT->pMouse->currentConstraint = nullptr;
     }
 
-    Debug::log(LOG, "Unconstrained mouse from %x", PCONSTRAINT->constraint);
+    DEBUGLOG(LOG, "Unconstrained mouse from %x", PCONSTRAINT->constraint);
 
     g_pInputManager->m_lConstraints.remove(*PCONSTRAINT);
 }
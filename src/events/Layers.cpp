@@ -14,6 +14,12 @@
 //                                               //
 // --------------------------------------------- //
 
+void damageBlurCacheForLayer(SLayerSurface* pLayer, SMonitor* pMonitor) {
+    // the tiled windows' blur is made from the layers below them
+    if (pMonitor && (pLayer->layer == ZWLR_LAYER_SHELL_V1_LAYER_BACKGROUND || pLayer->layer == ZWLR_LAYER_SHELL_V1_LAYER_BOTTOM))
+        g_pHyprOpenGL->markBlurDirtyForMonitor(pMonitor);
+}
+
 void Events::listener_newLayerSurface(wl_listener* listener, void* data) {
     const auto WLRLAYERSURFACE = (wlr_layer_surface_v1*)data;
 
@@ -21,12 +27,12 @@ void Events::listener_newLayerSurface(wl_listener* listener, void* data) {
         const auto PMONITOR = g_pCompositor->getMonitorFromCursor();
 
         if (!PMONITOR) {
-            Debug::log(ERR, "No monitor at cursor on new layer without a monitor. Ignoring.");
+            DEBUGLOG(ERR, "No monitor at cursor on new layer without a monitor. Ignoring.");
             wlr_layer_surface_v1_destroy(WLRLAYERSURFACE);
             return;
         }
 
-        Debug::log(LOG, "New LayerSurface has no preferred monitor. Assigning Monitor %s", PMONITOR->szName);
+        DEBUGLOG(LOG, "New LayerSurface has no preferred monitor. Assigning Monitor %s", PMONITOR->szName);
 
         WLRLAYERSURFACE->output = PMONITOR->output;
     }
@@ -50,13 +56,13 @@ void Events::listener_newLayerSurface(wl_listener* listener, void* data) {
     WLRLAYERSURFACE->data = layerSurface;
     layerSurface->monitorID = PMONITOR->ID;
 
-    Debug::log(LOG, "LayerSurface %x (namespace %s layer %d) created on monitor %s", layerSurface->layerSurface, layerSurface->layerSurface->_namespace, layerSurface->layer, PMONITOR->szName.c_str());
+    DEBUGLOG(LOG, "LayerSurface %x (namespace %s layer %d) created on monitor %s", layerSurface->layerSurface, layerSurface->layerSurface->_namespace, layerSurface->layer, PMONITOR->szName.c_str());
 }
 
 void Events::listener_destroyLayerSurface(void* owner, void* data) {
     SLayerSurface* layersurface = (SLayerSurface*)owner;
 
-    Debug::log(LOG, "LayerSurface %x destroyed", layersurface->layerSurface);
+    DEBUGLOG(LOG, "LayerSurface %x destroyed", layersurface->layerSurface);
 
     if (layersurface->layerSurface->mapped)
         layersurface->layerSurface->mapped = false;
@@ -72,9 +78,12 @@ void Events::listener_destroyLayerSurface(void* owner, void* data) {
 
     const auto PMONITOR = g_pCompositor->getMonitorFromID(layersurface->monitorID);
 
+    damageBlurCacheForLayer(layersurface, PMONITOR);
+
     // remove the layersurface as it's not used anymore
     PMONITOR->m_aLayerSurfaceLists[layersurface->layer].remove(layersurface);
     delete layersurface;
+    g_pCompositor->sceneChanged();
 
     // rearrange to fix the reserved areas
     if (PMONITOR) {
@@ -86,9 +95,10 @@ void Events::listener_destroyLayerSurface(void* owner, void* data) {
 void Events::listener_mapLayerSurface(void* owner, void* data) {
     SLayerSurface* layersurface = (SLayerSurface*)owner;
 
-    Debug::log(LOG, "LayerSurface %x mapped", layersurface->layerSurface);
+    DEBUGLOG(LOG, "LayerSurface %x mapped", layersurface->layerSurface);
 
     layersurface->layerSurface->mapped = true;
+    g_pCompositor->sceneChanged();
 
     wlr_surface_send_enter(layersurface->layerSurface->surface, layersurface->layerSurface->output);
 
@@ -100,12 +110,15 @@ void Events::listener_mapLayerSurface(void* owner, void* data) {
         POLDMON->m_aLayerSurfaceLists[layersurface->layer].remove(layersurface);
         PMONITOR->m_aLayerSurfaceLists[layersurface->layer].push_back(layersurface);
         layersurface->monitorID = PMONITOR->ID;
+        g_pCompositor->sceneChanged();
         g_pLayoutManager->getCurrentLayout()->recalculateMonitor(POLDMON->ID);
         g_pHyprRenderer->arrangeLayersForMonitor(POLDMON->ID);
     }
 
     g_pHyprRenderer->arrangeLayersForMonitor(PMONITOR->ID);
 
+    damageBlurCacheForLayer(layersurface, PMONITOR);
+
     if (layersurface->layerSurface->current.keyboard_interactive)
         g_pCompositor->focusSurface(layersurface->layerSurface->surface);
 
@@ -115,13 +128,17 @@ void Events::listener_mapLayerSurface(void* owner, void* data) {
 void Events::listener_unmapLayerSurface(void* owner, void* data) {
     SLayerSurface* layersurface = (SLayerSurface*)owner;
 
-    Debug::log(LOG, "LayerSurface %x unmapped", layersurface->layerSurface);
+    DEBUGLOG(LOG, "LayerSurface %x unmapped", layersurface->layerSurface);
 
     if (layersurface->layerSurface->mapped)
         layersurface->layerSurface->mapped = false;
 
+    g_pCompositor->sceneChanged();
+
     if (layersurface->layerSurface->surface == g_pCompositor->m_pLastFocus)
         g_pCompositor->m_pLastFocus = nullptr;
+
+    damageBlurCacheForLayer(layersurface, g_pCompositor->getMonitorFromID(layersurface->monitorID));
 }
 
 void Events::listener_commitLayerSurface(void* owner, void* data) {
@@ -141,6 +158,7 @@ void Events::listener_commitLayerSurface(void* owner, void* data) {
         POLDMON->m_aLayerSurfaceLists[layersurface->layer].remove(layersurface);
         PMONITOR->m_aLayerSurfaceLists[layersurface->layer].push_back(layersurface);
         layersurface->monitorID = PMONITOR->ID;
+        g_pCompositor->sceneChanged();
         g_pLayoutManager->getCurrentLayout()->recalculateMonitor(POLDMON->ID);
         g_pHyprRenderer->arrangeLayersForMonitor(POLDMON->ID);
     }
@@ -149,15 +167,23 @@ void Events::listener_commitLayerSurface(void* owner, void* data) {
         g_pHyprRenderer->arrangeLayersForMonitor(PMONITOR->ID);
 
         if (layersurface->layer != layersurface->layerSurface->current.layer) {
+            damageBlurCacheForLayer(layersurface, PMONITOR); // the layer it's leaving
             PMONITOR->m_aLayerSurfaceLists[layersurface->layer].remove(layersurface);
             PMONITOR->m_aLayerSurfaceLists[layersurface->layerSurface->current.layer].push_back(layersurface);
             layersurface->layer = layersurface->layerSurface->current.layer;
+            g_pCompositor->sceneChanged();
         }
 
         g_pLayoutManager->getCurrentLayout()->recalculateMonitor(PMONITOR->ID);
     }
 
-    layersurface->position = Vector2D(layersurface->geometry.x, layersurface->geometry.y);
+    const auto NEWPOS = Vector2D(layersurface->geometry.x, layersurface->geometry.y);
+
+    // a commit that only asks for the next frame leaves the cache good, it's stale if the layer drew something or changed its state
+    if (pixman_region32_not_empty(&layersurface->layerSurface->surface->buffer_damage) || layersurface->layerSurface->current.committed != 0 || NEWPOS != layersurface->position)
+        damageBlurCacheForLayer(layersurface, PMONITOR);
+
+    layersurface->position = NEWPOS;
 
     g_pHyprRenderer->damageBox(&layersurface->geometry);
 }
\ No newline at end of file
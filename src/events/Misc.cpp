@@ -39,7 +39,7 @@ void Events::listener_readyXWayland(wl_listener* listener, void* data) {
     const auto XCBCONNECTION = xcb_connect(g_pXWaylandManager->m_sWLRXWayland->display_name, NULL);
     const auto ERR = xcb_connection_has_error(XCBCONNECTION);
     if (ERR) {
-        Debug::log(LogLevel::ERR, "XWayland -> xcb_connection_has_error failed with %i", ERR);
+        DEBUGLOG(LogLevel::ERR, "XWayland -> xcb_connection_has_error failed with %i", ERR);
         return;
     }
 
@@ -48,7 +48,7 @@ void Events::listener_readyXWayland(wl_listener* listener, void* data) {
         xcb_intern_atom_reply_t* reply = xcb_intern_atom_reply(XCBCONNECTION, cookie, NULL);
 
         if (!reply) {
-            Debug::log(LogLevel::ERR, "XWayland -> Atom failed: %s", ATOM.first.c_str());
+            DEBUGLOG(LogLevel::ERR, "XWayland -> Atom failed: %s", ATOM.first.c_str());
             continue;
         }
 
@@ -69,7 +69,7 @@ void Events::listener_requestDrag(wl_listener* listener, void* data) {
     const auto E = (wlr_seat_request_start_drag_event*)data;
 
     if (!wlr_seat_validate_pointer_grab_serial(g_pCompositor->m_sSeat.seat, E->origin, E->serial)) {
-        Debug::log(LOG, "Ignoring drag and drop request: serial mismatch.");
+        DEBUGLOG(LOG, "Ignoring drag and drop request: serial mismatch.");
         wlr_data_source_destroy(E->drag->source);
         return;
     }
@@ -86,14 +86,14 @@ void Events::listener_startDrag(wl_listener* listener, void* data) {
 
     wlr_drag* wlrDrag = (wlr_drag*)data;
 
-    Debug::log(LOG, "Started drag %x", wlrDrag);
+    DEBUGLOG(LOG, "Started drag %x", wlrDrag);
 
     wlrDrag->data = data;
 
     g_pInputManager->m_sDrag.hyprListener_destroy.initCallback(&wlrDrag->events.destroy, &Events::listener_destroyDrag, &g_pInputManager->m_sDrag, "Drag");
 
     if (wlrDrag->icon) {
-        Debug::log(LOG, "Drag started with an icon %x", wlrDrag->icon);
+        DEBUGLOG(LOG, "Drag started with an icon %x", wlrDrag->icon);
 
         g_pInputManager->m_sDrag.dragIcon = wlrDrag->icon;
         wlrDrag->icon->data = g_pInputManager->m_sDrag.dragIcon;
@@ -106,29 +106,33 @@ void Events::listener_startDrag(wl_listener* listener, void* data) {
 }
 
 void Events::listener_destroyDrag(void* owner, void* data) {
-    Debug::log(LOG, "Drag destroyed.");
+    DEBUGLOG(LOG, "Drag destroyed.");
 
     g_pInputManager->m_sDrag.drag = nullptr;
     g_pInputManager->m_sDrag.dragIcon = nullptr;
     g_pInputManager->m_sDrag.hyprListener_destroy.removeCallback();
+    g_pCompositor->sceneChanged();
 
     g_pInputManager->refocus();
 }
 
 void Events::listener_mapDragIcon(void* owner, void* data) {
-    Debug::log(LOG, "Drag icon mapped.");
+    DEBUGLOG(LOG, "Drag icon mapped.");
     g_pInputManager->m_sDrag.iconMapped = true;
+    g_pCompositor->sceneChanged();
 }
 
 void Events::listener_unmapDragIcon(void* owner, void* data) {
-    Debug::log(LOG, "Drag icon unmapped.");
+    DEBUGLOG(LOG, "Drag icon unmapped.");
     g_pInputManager->m_sDrag.iconMapped = false;
+    g_pCompositor->sceneChanged();
 }
 
 void Events::listener_destroyDragIcon(void* owner, void* data) {
-    Debug::log(LOG, "Drag icon destroyed.");
+    DEBUGLOG(LOG, "Drag icon destroyed.");
 
     g_pInputManager->m_sDrag.dragIcon = nullptr;
+    g_pCompositor->sceneChanged();
     g_pInputManager->m_sDrag.hyprListener_commitIcon.removeCallback();
     g_pInputManager->m_sDrag.hyprListener_destroyIcon.removeCallback();
     g_pInputManager->m_sDrag.hyprListener_mapIcon.removeCallback();
@@ -138,18 +142,18 @@ void Events::listener_destroyDragIcon(void* owner, void* data) {
 void Events::listener_commitDragIcon(void* owner, void* data) {
     g_pInputManager->updateDragIcon();
 
-    Debug::log(LOG, "Drag icon committed.");
+    DEBUGLOG(LOG, "Drag icon committed.");
 }
 
 void Events::listener_InhibitActivate(wl_listener* listener, void* data) {
-    Debug::log(LOG, "Activated exclusive for %x.", g_pCompositor->m_sSeat.exclusiveClient);
+    DEBUGLOG(LOG, "Activated exclusive for %x.", g_pCompositor->m_sSeat.exclusiveClient);
     
     g_pInputManager->refocus();
     g_pCompositor->m_sSeat.exclusiveClient = g_pCompositor->m_sWLRInhibitMgr->active_client;
 }
 
 void Events::listener_InhibitDeactivate(wl_listener* listener, void* data) {
-    Debug::log(LOG, "Deactivated exclusive.");
+    DEBUGLOG(LOG, "Deactivated exclusive.");
 
     g_pCompositor->m_sSeat.exclusiveClient = nullptr;
     g_pInputManager->refocus();
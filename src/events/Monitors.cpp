@@ -76,6 +76,8 @@ void Events::listener_newOutput(wl_listener* listener, void* data) {
 
     g_pCompositor->m_lMonitors.push_back(newMonitor);
     const auto PNEWMONITOR = &g_pCompositor->m_lMonitors.back();
+    g_pCompositor->m_mOutputMonitors[OUTPUT] = PNEWMONITOR;
+    g_pCompositor->m_mMonitorIDs[PNEWMONITOR->ID] = PNEWMONITOR;
 
     PNEWMONITOR->hyprListener_monitorFrame.initCallback(&OUTPUT->events.frame, &Events::listener_monitorFrame, PNEWMONITOR);
     PNEWMONITOR->hyprListener_monitorDestroy.initCallback(&OUTPUT->events.destroy, &Events::listener_monitorDestroy, PNEWMONITOR);
@@ -97,13 +99,13 @@ void Events::listener_newOutput(wl_listener* listener, void* data) {
                 wlr_output_set_mode(OUTPUT, mode);
 
                 if (!wlr_output_test(OUTPUT)) {
-                    Debug::log(LOG, "Monitor %s: REJECTED available mode: %ix%i@%2f!",
+                    DEBUGLOG(LOG, "Monitor %s: REJECTED available mode: %ix%i@%2f!",
                                OUTPUT->name, (int)monitorRule.resolution.x, (int)monitorRule.resolution.y, (float)monitorRule.refreshRate,
                                mode->width, mode->height, mode->refresh / 1000.f);
                     continue;
                 }
 
-                Debug::log(LOG, "Monitor %s: requested %ix%i@%2f, found available mode: %ix%i@%2f, applying.",
+                DEBUGLOG(LOG, "Monitor %s: requested %ix%i@%2f, found available mode: %ix%i@%2f, applying.",
                            OUTPUT->name, (int)monitorRule.resolution.x, (int)monitorRule.resolution.y, (float)monitorRule.refreshRate,
                            mode->width, mode->height, mode->refresh / 1000.f);
 
@@ -117,7 +119,7 @@ void Events::listener_newOutput(wl_listener* listener, void* data) {
             const auto PREFERREDMODE = wlr_output_preferred_mode(OUTPUT);
 
             if (!PREFERREDMODE) {
-                Debug::log(ERR, "Monitor %s has NO PREFERRED MODE, and an INVALID one was requested: %ix%i@%2f",
+                DEBUGLOG(ERR, "Monitor %s has NO PREFERRED MODE, and an INVALID one was requested: %ix%i@%2f",
                            (int)monitorRule.resolution.x, (int)monitorRule.resolution.y, (float)monitorRule.refreshRate);
                 return;
             }
@@ -125,18 +127,18 @@ void Events::listener_newOutput(wl_listener* listener, void* data) {
             // Preferred is valid
             wlr_output_set_mode(OUTPUT, PREFERREDMODE);
 
-            Debug::log(ERR, "Monitor %s got an invalid requested mode: %ix%i@%2f, using the preferred one instead: %ix%i@%2f",
+            DEBUGLOG(ERR, "Monitor %s got an invalid requested mode: %ix%i@%2f, using the preferred one instead: %ix%i@%2f",
                        OUTPUT->name, (int)monitorRule.resolution.x, (int)monitorRule.resolution.y, (float)monitorRule.refreshRate,
                        PREFERREDMODE->width, PREFERREDMODE->height, PREFERREDMODE->refresh / 1000.f);
         }
     }
 
     if (!wlr_output_commit(OUTPUT)) {
-        Debug::log(ERR, "Couldn't commit output named %s", OUTPUT->name);
+        DEBUGLOG(ERR, "Couldn't commit output named %s", OUTPUT->name);
         return;
     }
 
-    Debug::log(LOG, "Added new monitor with name %s at %i,%i with size %ix%i@%i, pointer %x", OUTPUT->name, (int)monitorRule.offset.x, (int)monitorRule.offset.y, (int)monitorRule.resolution.x, (int)monitorRule.resolution.y, (int)monitorRule.refreshRate, OUTPUT);
+    DEBUGLOG(LOG, "Added new monitor with name %s at %i,%i with size %ix%i@%i, pointer %x", OUTPUT->name, (int)monitorRule.offset.x, (int)monitorRule.offset.y, (int)monitorRule.resolution.x, (int)monitorRule.resolution.y, (int)monitorRule.refreshRate, OUTPUT);
 
     // add a WLR workspace group
     PNEWMONITOR->pWLRWorkspaceGroupHandle = wlr_ext_workspace_group_handle_v1_create(g_pCompositor->m_sWLREXTWorkspaceMgr);
@@ -154,13 +156,17 @@ void Events::listener_newOutput(wl_listener* listener, void* data) {
 
     PNEWWORKSPACE->m_iID = WORKSPACEID;
     PNEWWORKSPACE->m_iMonitorID = newMonitor.ID;
+    g_pCompositor->m_mWorkspaceIDs[WORKSPACEID] = PNEWWORKSPACE;
 
     PNEWMONITOR->activeWorkspace = PNEWWORKSPACE->m_iID;
+    g_pCompositor->sceneChanged();
 
     PNEWMONITOR->scale = monitorRule.scale;
 
     g_pCompositor->deactivateAllWLRWorkspaces();
     wlr_ext_workspace_handle_v1_set_active(PNEWWORKSPACE->m_pWlrHandle, true);
+
+    g_pEventManager->postEvent(SHyprIPCEvent{"monitoradded", PNEWMONITOR->szName});
     //
 }
 
@@ -171,36 +177,66 @@ void Events::listener_monitorFrame(void* owner, void* data) {
     // This is for stuff that should be run every frame
     // TODO: do this on the most Hz monitor
     if (PMONITOR->ID == 0) {
-        g_pCompositor->sanityCheckWorkspaces();
         g_pAnimationManager->tick();
         g_pCompositor->cleanupWindows();
 
+#ifdef HYPRLAND_DEBUG
+        g_pCompositor->checkIndexConsistency();
+#endif
+
         g_pConfigManager->dispatchExecOnce(); // We exec-once when at least one monitor starts refreshing, meaning stuff has init'd
     }
 
     timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
 
+    if (g_pHyprRenderer->attemptDirectScanout(PMONITOR)) {
+        PMONITOR->directScanout = true;
+        g_pHyprRenderer->sendFrameEventsToMonitor(PMONITOR, &now);
+        wlr_output_schedule_frame(PMONITOR->output);
+        return;
+    }
+
+    if (PMONITOR->directScanout) {
+        // our buffers are stale after scanning out the client's, redraw everything
+        DEBUGLOG(LOG, "Monitor %s: stopped direct scanout", PMONITOR->szName.c_str());
+        PMONITOR->directScanout = false;
+        wlr_output_damage_add_whole(PMONITOR->damage);
+    }
+
     // check the damage
     pixman_region32_t damage;
     bool hasChanged;
     pixman_region32_init(&damage);
 
-    const auto DTMODE = g_pConfigManager->getInt("general:damage_tracking_internal");
+    static const CConfigHandle<int64_t> DAMAGETRACKING("general:damage_tracking_internal");
+
+    const auto DTMODE = *DAMAGETRACKING;
 
     if (DTMODE == -1) {
-        Debug::log(CRIT, "Damage tracking mode -1 ????");
+        DEBUGLOG(CRIT, "Damage tracking mode -1 ????");
         return;
     }
 
+    // primaryFB misses the frames drawn straight to the output, so it has to be redrawn whole before it's used again
+    const bool DIRECTTOOUTPUT = g_pHyprRenderer->shouldRenderDirectlyToOutput(PMONITOR);
+    const auto PMONRENDERDATA = &g_pHyprOpenGL->m_mMonitorRenderResources[PMONITOR];
+    if (DIRECTTOOUTPUT) {
+        PMONRENDERDATA->primaryFBStale = true;
+    } else if (PMONRENDERDATA->primaryFBStale) {
+        PMONRENDERDATA->primaryFBStale = false;
+        wlr_output_damage_add_whole(PMONITOR->damage);
+    }
+
     if (!wlr_output_damage_attach_render(PMONITOR->damage, &hasChanged, &damage)){
-        Debug::log(ERR, "Couldn't attach render to display %s ???", PMONITOR->szName.c_str());
+        DEBUGLOG(ERR, "Couldn't attach render to display %s ???", PMONITOR->szName.c_str());
         return;
     }
 
     if (!hasChanged && DTMODE != DAMAGE_TRACKING_NONE) {
         pixman_region32_fini(&damage);
         wlr_output_rollback(PMONITOR->output);
+        g_pHyprRenderer->sendFrameEventsToMonitor(PMONITOR, &now);
         wlr_output_schedule_frame(PMONITOR->output); // we update shit at the monitor's Hz so we need to schedule frames because rollback wont
         return;
     }
@@ -213,7 +249,7 @@ void Events::listener_monitorFrame(void* owner, void* data) {
     // TODO: this is getting called with extents being 0,0,0,0 should it be?
     // potentially can save on resources.
 
-    g_pHyprOpenGL->begin(PMONITOR, &damage);
+    g_pHyprOpenGL->begin(PMONITOR, &damage, DIRECTTOOUTPUT);
     g_pHyprOpenGL->clear(CColor(11, 11, 11, 255));
     g_pHyprOpenGL->clearWithTex(); // will apply the hypr "wallpaper"
 
@@ -258,7 +294,12 @@ void Events::listener_monitorDestroy(void* owner, void* data) {
     if (!pMonitor)
         return;
 
+    g_pEventManager->postEvent(SHyprIPCEvent{"monitorremoved", pMonitor->szName});
+
+    g_pCompositor->m_mOutputMonitors.erase(pMonitor->output);
+    g_pCompositor->m_mMonitorIDs.erase(pMonitor->ID);
     g_pCompositor->m_lMonitors.remove(*pMonitor);
+    g_pCompositor->sceneChanged();
 
     // TODO: cleanup windows
 }
@@ -42,6 +42,7 @@ void addPopupGlobalCoords(void* pPopup, int* x, int* y) {
 
 void createNewPopup(wlr_xdg_popup* popup, SXDGPopup* pHyprPopup) {
     pHyprPopup->popup = popup;
+    g_pCompositor->m_mPopups[popup] = pHyprPopup;
 
     pHyprPopup->hyprListener_destroyPopupXDG.initCallback(&popup->base->surface->events.destroy, &Events::listener_destroyPopupXDG, pHyprPopup, "HyprPopup");
     pHyprPopup->hyprListener_mapPopupXDG.initCallback(&popup->base->events.map, &Events::listener_mapPopupXDG, pHyprPopup, "HyprPopup");
@@ -56,7 +57,7 @@ void createNewPopup(wlr_xdg_popup* popup, SXDGPopup* pHyprPopup) {
 
     pHyprPopup->monitor = PMONITOR;
 
-    Debug::log(LOG, "Popup: Unconstrained from lx ly: %f %f, pHyprPopup lx ly: %f %f", (float)PMONITOR->vecPosition.x, (float)PMONITOR->vecPosition.y, (float)pHyprPopup->lx, (float)pHyprPopup->ly);
+    DEBUGLOG(LOG, "Popup: Unconstrained from lx ly: %f %f, pHyprPopup lx ly: %f %f", (float)PMONITOR->vecPosition.x, (float)PMONITOR->vecPosition.y, (float)pHyprPopup->lx, (float)pHyprPopup->ly);
 }
 
 void Events::listener_newPopup(void* owner, void* data) {
@@ -64,7 +65,7 @@ void Events::listener_newPopup(void* owner, void* data) {
 
     ASSERT(layersurface);
 
-    Debug::log(LOG, "New layer popup created from surface %x", layersurface);
+    DEBUGLOG(LOG, "New layer popup created from surface %x", layersurface);
 
     const auto WLRPOPUP = (wlr_xdg_popup*)data;
 
@@ -85,7 +86,7 @@ void Events::listener_newPopupXDG(void* owner, void* data) {
 
     ASSERT(PWINDOW);
 
-    Debug::log(LOG, "New layer popup created from XDG window %x -> %s", PWINDOW, PWINDOW->m_szTitle.c_str());
+    DEBUGLOG(LOG, "New layer popup created from XDG window %x -> %s", PWINDOW, PWINDOW->m_szTitle.c_str());
 
     const auto WLRPOPUP = (wlr_xdg_popup*)data;
 
@@ -97,7 +98,7 @@ void Events::listener_newPopupXDG(void* owner, void* data) {
     PNEWPOPUP->popup = WLRPOPUP;
     PNEWPOPUP->lx = PWINDOW->m_vEffectivePosition.x;
     PNEWPOPUP->ly = PWINDOW->m_vEffectivePosition.y;
-    PNEWPOPUP->parentWindow = PWINDOW;
+    PNEWPOPUP->parentWindow = g_pCompositor->m_WindowRegistry.handleOf(PWINDOW);
     PNEWPOPUP->monitor = PMONITOR;
     createNewPopup(WLRPOPUP, PNEWPOPUP);
 }
@@ -107,10 +108,10 @@ void Events::listener_newPopupFromPopupXDG(void* owner, void* data) {
 
     ASSERT(PPOPUP);
     
-    if (PPOPUP->parentWindow)
-        Debug::log(LOG, "New popup created from XDG Window popup %x -> %s", PPOPUP, PPOPUP->parentWindow->m_szTitle.c_str());
+    if (const auto PPARENT = g_pCompositor->m_WindowRegistry.get(PPOPUP->parentWindow); PPARENT)
+        DEBUGLOG(LOG, "New popup created from XDG Window popup %x -> %s", PPOPUP, PPARENT->m_szTitle.c_str());
     else
-        Debug::log(LOG, "New popup created from Non-Window popup %x", PPOPUP);
+        DEBUGLOG(LOG, "New popup created from Non-Window popup %x", PPOPUP);
 
     const auto WLRPOPUP = (wlr_xdg_popup*)data;
 
@@ -132,16 +133,16 @@ void Events::listener_mapPopupXDG(void* owner, void* data) {
 
     ASSERT(PPOPUP);
 
-    Debug::log(LOG, "New XDG Popup mapped at %d %d", (int)PPOPUP->lx, (int)PPOPUP->ly);
+    DEBUGLOG(LOG, "New XDG Popup mapped at %d %d", (int)PPOPUP->lx, (int)PPOPUP->ly);
 
     PPOPUP->pSurfaceTree = SubsurfaceTree::createTreeRoot(PPOPUP->popup->base->surface, addPopupGlobalCoords, PPOPUP);
 
-    Debug::log(LOG, "XDG Popup got assigned a surfaceTreeNode %x", PPOPUP->pSurfaceTree);
+    DEBUGLOG(LOG, "XDG Popup got assigned a surfaceTreeNode %x", PPOPUP->pSurfaceTree);
 }
 
 void Events::listener_unmapPopupXDG(void* owner, void* data) {
     SXDGPopup* PPOPUP = (SXDGPopup*)owner;
-    Debug::log(LOG, "XDG Popup unmapped");
+    DEBUGLOG(LOG, "XDG Popup unmapped");
 
     ASSERT(PPOPUP);
 
@@ -155,12 +156,13 @@ void Events::listener_destroyPopupXDG(void* owner, void* data) {
 
     ASSERT(PPOPUP);
 
-    Debug::log(LOG, "Destroyed popup XDG %x", PPOPUP);
+    DEBUGLOG(LOG, "Destroyed popup XDG %x", PPOPUP);
 
     if (PPOPUP->pSurfaceTree) {
         SubsurfaceTree::destroySurfaceTree(PPOPUP->pSurfaceTree);
         PPOPUP->pSurfaceTree = nullptr;
     }
 
+    g_pCompositor->m_mPopups.erase(PPOPUP->popup);
     g_pCompositor->m_lXDGPopups.remove(*PPOPUP);
 }
\ No newline at end of file
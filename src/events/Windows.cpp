@@ -28,8 +28,8 @@ void Events::listener_mapWindow(void* owner, void* data) {
     const auto PWORKSPACE = g_pCompositor->getWorkspaceByID(PMONITOR->activeWorkspace);
     PWINDOW->m_iMonitorID = PMONITOR->ID;
     PWINDOW->m_bMappedX11 = true;
-    PWINDOW->m_iWorkspaceID = PMONITOR->activeWorkspace;
-    PWINDOW->m_bIsMapped = true;
+    g_pCompositor->setWindowWorkspace(PWINDOW, PMONITOR->activeWorkspace);
+    g_pCompositor->setWindowMapped(PWINDOW, true);
     PWINDOW->m_bReadyToDelete = false;
     PWINDOW->m_bFadingOut = false;
     PWINDOW->m_szTitle = g_pXWaylandManager->getTitle(PWINDOW);
@@ -40,10 +40,12 @@ void Events::listener_mapWindow(void* owner, void* data) {
     const auto PWINDOWSURFACE = g_pXWaylandManager->getWindowSurface(PWINDOW);
 
     if (!PWINDOWSURFACE) {
-        g_pCompositor->m_lWindows.remove(*PWINDOW);
+        g_pCompositor->removeWindowFromVectorSafe(PWINDOW);
         return;
     }
 
+    g_pCompositor->indexSurfaceTree(PWINDOWSURFACE, PWINDOW);
+
     if (g_pXWaylandManager->shouldBeFloated(PWINDOW))
         PWINDOW->m_bIsFloating = true;
 
@@ -66,11 +68,11 @@ void Events::listener_mapWindow(void* owner, void* data) {
                 else
                     PWINDOW->m_iMonitorID = MONITOR;
 
-                PWINDOW->m_iWorkspaceID = g_pCompositor->getMonitorFromID(PWINDOW->m_iMonitorID)->activeWorkspace;
+                g_pCompositor->setWindowWorkspace(PWINDOW, g_pCompositor->getMonitorFromID(PWINDOW->m_iMonitorID)->activeWorkspace);
 
-                Debug::log(LOG, "Rule monitor, applying to window %x -> mon: %i, workspace: %i", PWINDOW, PWINDOW->m_iMonitorID, PWINDOW->m_iWorkspaceID);
+                DEBUGLOG(LOG, "Rule monitor, applying to window %x -> mon: %i, workspace: %i", PWINDOW, PWINDOW->m_iMonitorID, PWINDOW->m_iWorkspaceID);
             } catch (...) {
-                Debug::log(LOG, "Rule monitor failed, rule: %s -> %s", r.szRule.c_str(), r.szValue.c_str());
+                DEBUGLOG(LOG, "Rule monitor failed, rule: %s -> %s", r.szRule.c_str(), r.szValue.c_str());
             }
         } else if (r.szRule.find("float") == 0) {
             PWINDOW->m_bIsFloating = true;
@@ -93,12 +95,12 @@ void Events::listener_mapWindow(void* owner, void* data) {
                     const auto SIZEX = stoi(VALUE.substr(0, VALUE.find(" ")));
                     const auto SIZEY = stoi(VALUE.substr(VALUE.find(" ") + 1));
 
-                    Debug::log(LOG, "Rule size, applying to window %x", PWINDOW);
+                    DEBUGLOG(LOG, "Rule size, applying to window %x", PWINDOW);
 
                     PWINDOW->m_vEffectiveSize = Vector2D(SIZEX, SIZEY);
                     g_pXWaylandManager->setWindowSize(PWINDOW, PWINDOW->m_vEffectiveSize);
                 } catch (...) {
-                    Debug::log(LOG, "Rule size failed, rule: %s -> %s", r.szRule.c_str(), r.szValue.c_str());
+                    DEBUGLOG(LOG, "Rule size failed, rule: %s -> %s", r.szRule.c_str(), r.szValue.c_str());
                 }
             } else if (r.szRule.find("move") == 0) {
                 try {
@@ -106,11 +108,11 @@ void Events::listener_mapWindow(void* owner, void* data) {
                     const auto POSX = stoi(VALUE.substr(0, VALUE.find(" ")));
                     const auto POSY = stoi(VALUE.substr(VALUE.find(" ") + 1));
 
-                    Debug::log(LOG, "Rule move, applying to window %x", PWINDOW);
+                    DEBUGLOG(LOG, "Rule move, applying to window %x", PWINDOW);
 
                     PWINDOW->m_vEffectivePosition = Vector2D(POSX, POSY) + PMONITOR->vecPosition;
                 } catch (...) {
-                    Debug::log(LOG, "Rule move failed, rule: %s -> %s", r.szRule.c_str(), r.szValue.c_str());
+                    DEBUGLOG(LOG, "Rule move failed, rule: %s -> %s", r.szRule.c_str(), r.szValue.c_str());
                 }
             }
         }
@@ -130,10 +132,14 @@ void Events::listener_mapWindow(void* owner, void* data) {
 
     PWINDOW->m_pSurfaceTree = SubsurfaceTree::createTreeRoot(g_pXWaylandManager->getWindowSurface(PWINDOW), addViewCoords, PWINDOW);
 
-    Debug::log(LOG, "Window got assigned a surfaceTreeNode %x", PWINDOW->m_pSurfaceTree);
+    // the toplevel surface itself is damaged in listener_commitWindow, the tree only takes care of the subsurfaces
+    PWINDOW->m_pSurfaceTree->hyprListener_commit.removeCallback();
+
+    DEBUGLOG(LOG, "Window got assigned a surfaceTreeNode %x", PWINDOW->m_pSurfaceTree);
+
+    PWINDOW->hyprListener_commitWindow.initCallback(&PWINDOWSURFACE->events.commit, &Events::listener_commitWindow, PWINDOW, PWINDOW->m_bIsX11 ? "XWayland Window Late" : "XDG Window Late");
 
     if (!PWINDOW->m_bIsX11) {
-        PWINDOW->hyprListener_commitWindow.initCallback(&PWINDOW->m_uSurface.xdg->surface->events.commit, &Events::listener_commitWindow, PWINDOW, "XDG Window Late");
         PWINDOW->hyprListener_setTitleWindow.initCallback(&PWINDOW->m_uSurface.xdg->toplevel->events.set_title, &Events::listener_setTitleWindow, PWINDOW, "XDG Window Late");
         PWINDOW->hyprListener_fullscreenWindow.initCallback(&PWINDOW->m_uSurface.xdg->toplevel->events.request_fullscreen, &Events::listener_fullscreenWindow, PWINDOW, "XDG Window Late");
         PWINDOW->hyprListener_newPopupXDG.initCallback(&PWINDOW->m_uSurface.xdg->events.new_popup, &Events::listener_newPopupXDG, PWINDOW, "XDG Window Late");
@@ -144,22 +150,27 @@ void Events::listener_mapWindow(void* owner, void* data) {
         PWINDOW->hyprListener_setTitleWindow.initCallback(&PWINDOW->m_uSurface.xwayland->events.set_title, &Events::listener_setTitleWindow, PWINDOW, "XWayland Window Late");
     }
 
-    Debug::log(LOG, "Map request dispatched, monitor %s, xywh: %f %f %f %f", PMONITOR->szName.c_str(), PWINDOW->m_vEffectivePosition.x, PWINDOW->m_vEffectivePosition.y, PWINDOW->m_vEffectiveSize.x, PWINDOW->m_vEffectiveSize.y);
+    g_pEventManager->postEvent(SHyprIPCEvent{"openwindow", getFormat("%lx,%i,%s,%s", (uintptr_t)PWINDOW, PWINDOW->m_iWorkspaceID, g_pXWaylandManager->getAppIDClass(PWINDOW).c_str(), PWINDOW->m_szTitle.c_str())});
+
+    DEBUGLOG(LOG, "Map request dispatched, monitor %s, xywh: %f %f %f %f", PMONITOR->szName.c_str(), PWINDOW->m_vEffectivePosition.x, PWINDOW->m_vEffectivePosition.y, PWINDOW->m_vEffectiveSize.x, PWINDOW->m_vEffectiveSize.y);
 }
 
 void Events::listener_unmapWindow(void* owner, void* data) {
     CWindow* PWINDOW = (CWindow*)owner;
 
-    Debug::log(LOG, "Window %x unmapped", PWINDOW);
+    DEBUGLOG(LOG, "Window %x unmapped", PWINDOW);
+
+    g_pEventManager->postEvent(SHyprIPCEvent{"closewindow", getFormat("%lx", (uintptr_t)PWINDOW)});
 
     if (!PWINDOW->m_bIsX11) {
-        Debug::log(LOG, "Unregistered late callbacks XDG: %x %x %x %x", &PWINDOW->hyprListener_commitWindow.m_sListener.link, &PWINDOW->hyprListener_setTitleWindow.m_sListener.link, &PWINDOW->hyprListener_fullscreenWindow.m_sListener.link, &PWINDOW->hyprListener_newPopupXDG.m_sListener.link);
+        DEBUGLOG(LOG, "Unregistered late callbacks XDG: %x %x %x %x", &PWINDOW->hyprListener_commitWindow.m_sListener.link, &PWINDOW->hyprListener_setTitleWindow.m_sListener.link, &PWINDOW->hyprListener_fullscreenWindow.m_sListener.link, &PWINDOW->hyprListener_newPopupXDG.m_sListener.link);
         PWINDOW->hyprListener_commitWindow.removeCallback();
         PWINDOW->hyprListener_setTitleWindow.removeCallback();
         PWINDOW->hyprListener_fullscreenWindow.removeCallback();
         PWINDOW->hyprListener_newPopupXDG.removeCallback();
     } else {
-        Debug::log(LOG, "Unregistered late callbacks XWL: %x %x %x %x", &PWINDOW->hyprListener_fullscreenWindow.m_sListener.link, &PWINDOW->hyprListener_activateX11.m_sListener.link, &PWINDOW->hyprListener_configureX11.m_sListener.link, &PWINDOW->hyprListener_setTitleWindow.m_sListener.link);
+        DEBUGLOG(LOG, "Unregistered late callbacks XWL: %x %x %x %x %x", &PWINDOW->hyprListener_commitWindow.m_sListener.link, &PWINDOW->hyprListener_fullscreenWindow.m_sListener.link, &PWINDOW->hyprListener_activateX11.m_sListener.link, &PWINDOW->hyprListener_configureX11.m_sListener.link, &PWINDOW->hyprListener_setTitleWindow.m_sListener.link);
+        PWINDOW->hyprListener_commitWindow.removeCallback();
         PWINDOW->hyprListener_fullscreenWindow.removeCallback();
         PWINDOW->hyprListener_activateX11.removeCallback();
         PWINDOW->hyprListener_configureX11.removeCallback();
@@ -185,12 +196,14 @@ void Events::listener_unmapWindow(void* owner, void* data) {
     g_pLayoutManager->getCurrentLayout()->onWindowRemoved(PWINDOW);
 
     // do this after onWindowRemoved because otherwise it'll think the window is invalid
-    PWINDOW->m_bIsMapped = false;
+    g_pCompositor->setWindowMapped(PWINDOW, false);
+    if (const auto PSURFACE = g_pXWaylandManager->getWindowSurface(PWINDOW))
+        g_pCompositor->unindexSurfaceTree(PSURFACE);
 
     // refocus on a new window
     g_pInputManager->refocus();
 
-    Debug::log(LOG, "Destroying the SubSurface tree of unmapped window %x", PWINDOW);
+    DEBUGLOG(LOG, "Destroying the SubSurface tree of unmapped window %x", PWINDOW);
     SubsurfaceTree::destroySurfaceTree(PWINDOW->m_pSurfaceTree);
     
     PWINDOW->m_pSurfaceTree = nullptr;
@@ -200,6 +213,9 @@ void Events::listener_unmapWindow(void* owner, void* data) {
     g_pCompositor->m_lWindowsFadingOut.push_back(PWINDOW);
 
     g_pHyprRenderer->damageMonitor(g_pCompositor->getMonitorFromID(PWINDOW->m_iMonitorID));
+
+    // the workspace might be empty and hidden now
+    g_pCompositor->sanityCheckWorkspaces();
 }
 
 void Events::listener_commitWindow(void* owner, void* data) {
@@ -208,13 +224,25 @@ void Events::listener_commitWindow(void* owner, void* data) {
     if (!g_pCompositor->windowValidMapped(PWINDOW))
         return;
 
-    // Debug::log(LOG, "Window %x committed", PWINDOW); // SPAM!
+    const auto PSURFACE = g_pXWaylandManager->getWindowSurface(PWINDOW);
+
+    if (!PSURFACE)
+        return;
+
+    // the toplevel is drawn stretched to its real size, so the surface-local damage
+    // only maps 1:1 if the buffer matches it. If it doesn't (mid-resize), damage the whole window.
+    if (PSURFACE->current.width != (int)PWINDOW->m_vRealSize.x || PSURFACE->current.height != (int)PWINDOW->m_vRealSize.y)
+        g_pHyprRenderer->damageWindow(PWINDOW);
+    else
+        g_pHyprRenderer->damageSurface(PSURFACE, PWINDOW->m_vRealPosition.x, PWINDOW->m_vRealPosition.y);
+
+    // DEBUGLOG(LOG, "Window %x committed", PWINDOW); // SPAM!
 }
 
 void Events::listener_destroyWindow(void* owner, void* data) {
     CWindow* PWINDOW = (CWindow*)owner;
 
-    Debug::log(LOG, "Window %x destroyed, queueing.", PWINDOW);
+    DEBUGLOG(LOG, "Window %x destroyed, queueing.", PWINDOW);
 
     if (PWINDOW == g_pCompositor->m_pLastWindow) {
         g_pCompositor->m_pLastWindow = nullptr;
@@ -228,7 +256,7 @@ void Events::listener_destroyWindow(void* owner, void* data) {
     g_pLayoutManager->getCurrentLayout()->onWindowRemoved(PWINDOW);
 
     if (PWINDOW->m_pSurfaceTree) {
-        Debug::log(LOG, "Destroying Subsurface tree of %x in destroyWindow", PWINDOW);
+        DEBUGLOG(LOG, "Destroying Subsurface tree of %x in destroyWindow", PWINDOW);
         SubsurfaceTree::destroySurfaceTree(PWINDOW->m_pSurfaceTree);
         PWINDOW->m_pSurfaceTree = nullptr;
     }
@@ -244,7 +272,10 @@ void Events::listener_setTitleWindow(void* owner, void* data) {
 
     PWINDOW->m_szTitle = g_pXWaylandManager->getTitle(PWINDOW);
 
-    Debug::log(LOG, "Window %x set title to %s", PWINDOW, PWINDOW->m_szTitle.c_str());
+    DEBUGLOG(LOG, "Window %x set title to %s", PWINDOW, PWINDOW->m_szTitle.c_str());
+
+    // postEvent puts it on one line
+    g_pEventManager->postEvent(SHyprIPCEvent{"windowtitle", getFormat("%lx,%s", (uintptr_t)PWINDOW, PWINDOW->m_szTitle.c_str())});
 }
 
 void Events::listener_fullscreenWindow(void* owner, void* data) {
@@ -252,7 +283,7 @@ void Events::listener_fullscreenWindow(void* owner, void* data) {
 
     g_pLayoutManager->getCurrentLayout()->fullscreenRequestForWindow(PWINDOW);
 
-    Debug::log(LOG, "Window %x fullscreen to %i", PWINDOW, PWINDOW->m_bIsFullscreen);
+    DEBUGLOG(LOG, "Window %x fullscreen to %i", PWINDOW, PWINDOW->m_bIsFullscreen);
     
     g_pXWaylandManager->setWindowFullscreen(PWINDOW, PWINDOW->m_bIsFullscreen);
 }
@@ -291,6 +322,7 @@ void Events::listener_configureX11(void* owner, void* data) {
     PWINDOW->m_vRealSize = PWINDOW->m_vRealSize;
     PWINDOW->m_vPosition = PWINDOW->m_vPosition;
     PWINDOW->m_vSize = PWINDOW->m_vSize;
+    g_pCompositor->windowGeometryChanged(PWINDOW);
 
     wlr_seat_pointer_clear_focus(g_pCompositor->m_sSeat.seat);
 
@@ -300,10 +332,11 @@ void Events::listener_configureX11(void* owner, void* data) {
 void Events::listener_surfaceXWayland(wl_listener* listener, void* data) {
     const auto XWSURFACE = (wlr_xwayland_surface*)data;
 
-    Debug::log(LOG, "New XWayland Surface created.");
+    DEBUGLOG(LOG, "New XWayland Surface created.");
 
     g_pCompositor->m_lWindows.push_back(CWindow());
     const auto PNEWWINDOW = &g_pCompositor->m_lWindows.back();
+    g_pCompositor->m_WindowRegistry.add(PNEWWINDOW);
 
     PNEWWINDOW->m_uSurface.xwayland = XWSURFACE;
     PNEWWINDOW->m_iX11Type = XWSURFACE->override_redirect ? 2 : 1;
@@ -318,13 +351,14 @@ void Events::listener_newXDGSurface(wl_listener* listener, void* data) {
     // A window got opened
     const auto XDGSURFACE = (wlr_xdg_surface*)data;
 
-    Debug::log(LOG, "New XDG Surface created. (%ix%i at %i %i)", XDGSURFACE->current.geometry.width, XDGSURFACE->current.geometry.height, XDGSURFACE->current.geometry.x, XDGSURFACE->current.geometry.y);
+    DEBUGLOG(LOG, "New XDG Surface created. (%ix%i at %i %i)", XDGSURFACE->current.geometry.width, XDGSURFACE->current.geometry.height, XDGSURFACE->current.geometry.x, XDGSURFACE->current.geometry.y);
 
     if (XDGSURFACE->role != WLR_XDG_SURFACE_ROLE_TOPLEVEL)
         return;  // TODO: handle?
 
     g_pCompositor->m_lWindows.push_back(CWindow());
     const auto PNEWWINDOW = &g_pCompositor->m_lWindows.back();
+    g_pCompositor->m_WindowRegistry.add(PNEWWINDOW);
     PNEWWINDOW->m_uSurface.xdg = XDGSURFACE;
 
     PNEWWINDOW->hyprListener_mapWindow.initCallback(&XDGSURFACE->events.map, &Events::listener_mapWindow, PNEWWINDOW, "XDG Window");
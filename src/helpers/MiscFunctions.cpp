@@ -7,7 +7,7 @@ void addWLSignal(wl_signal* pSignal, wl_listener* pListener, void* pOwner, std::
     
     wl_signal_add(pSignal, pListener);
 
-    Debug::log(LOG, "Registered signal for owner %x: %x -> %x (owner: %s)", pOwner, pSignal, pListener, ownerString.c_str());
+    DEBUGLOG(LOG, "Registered signal for owner %x: %x -> %x (owner: %s)", pOwner, pSignal, pListener, ownerString.c_str());
 }
 
 void handleNoop(struct wl_listener *listener, void *data) {
@@ -5,6 +5,7 @@
 #include "WLClasses.hpp"
 #include <list>
 #include <array>
+#include <vector>
 
 struct SMonitor {
     Vector2D    vecPosition     = Vector2D(0,0);
@@ -25,6 +26,18 @@ struct SMonitor {
     wlr_output* output          = nullptr;
     float       refreshRate     = 60;
     wlr_output_damage* damage   = nullptr;
+    bool        directScanout   = false; // last frame was a client buffer, not ours
+
+    // retained draw order, bottom to top. Rebuilt by the renderer when the scene epoch moves on,
+    // only the windows' on-this-monitor flags are redone when the geometry epoch does.
+    std::vector<CWindow*> renderList;
+    std::vector<char> renderListOnMonitor; // per renderList entry
+    size_t      renderListTiled = 0; // the first n entries are tiled and share the blur cache
+    bool        renderListFullscreen = false;
+    std::array<std::vector<SLayerSurface*>, 4> renderListLayers; // the mapped ones, their popups go on top of everything
+    bool        renderListDragIcon = false;
+    uint64_t    renderListEpoch = UINT64_MAX;
+    uint64_t    renderListGeometryEpoch = UINT64_MAX;
     
     // Double-linked list because we need to have constant mem addresses for signals
     // We have to store pointers and use raw new/delete because they might be moved between them
@@ -0,0 +1,136 @@
+#include "PatternMatcher.hpp"
+#include <algorithm>
+#include <deque>
+#include <cctype>
+
+void CMultiPatternMatcher::clear() {
+    m_vPatterns.clear();
+    m_vRegexPatterns.clear();
+    m_vNodes = {SNode()};
+    m_pCombinedRegex.reset();
+}
+
+size_t CMultiPatternMatcher::add(const std::string& pattern) {
+    SPattern compiled;
+    compiled.szPattern = pattern;
+    compiled.bLiteral = pattern.find_first_of(".^$|()[]{}*+?\\") == std::string::npos;
+
+    if (!compiled.bLiteral)
+        compiled.regex = std::regex(pattern, std::regex::optimize);
+
+    const auto INDEX = m_vPatterns.size();
+
+    if (compiled.bLiteral) {
+        // add it to the trie, fail links are done in compile()
+        uint32_t node = 0;
+        for (const unsigned char c : pattern) {
+            const auto NEXT = edge(node, c);
+
+            if (NEXT != -1) {
+                node = NEXT;
+                continue;
+            }
+
+            auto& EDGES = m_vNodes[node].vEdges;
+            EDGES.insert(std::lower_bound(EDGES.begin(), EDGES.end(), std::make_pair(c, (uint32_t)0)), {c, (uint32_t)m_vNodes.size()});
+            node = m_vNodes.size();
+            m_vNodes.push_back(SNode());
+        }
+
+        m_vNodes[node].vOutputs.push_back(INDEX);
+    } else {
+        m_vRegexPatterns.push_back(INDEX);
+    }
+
+    m_vPatterns.push_back(std::move(compiled));
+
+    return INDEX;
+}
+
+void CMultiPatternMatcher::compile() {
+    // fail links, breadth first so a node's fail target is always done before it
+    std::deque<uint32_t> queue;
+
+    for (auto& [c, child] : m_vNodes[0].vEdges) {
+        m_vNodes[child].iFail = 0;
+        queue.push_back(child);
+    }
+
+    while (!queue.empty()) {
+        const auto NODE = queue.front();
+        queue.pop_front();
+
+        for (auto& [c, child] : m_vNodes[NODE].vEdges) {
+            uint32_t fail = m_vNodes[NODE].iFail;
+            int64_t  next = edge(fail, c);
+
+            while (next == -1 && fail != 0) {
+                fail = m_vNodes[fail].iFail;
+                next = edge(fail, c);
+            }
+
+            m_vNodes[child].iFail = next == -1 ? 0 : next;
+
+            const auto& FAILOUTPUTS = m_vNodes[m_vNodes[child].iFail].vOutputs;
+            m_vNodes[child].vOutputs.insert(m_vNodes[child].vOutputs.end(), FAILOUTPUTS.begin(), FAILOUTPUTS.end());
+
+            queue.push_back(child);
+        }
+    }
+
+    // one alternation of every regex. Backreferences would point at the wrong group in it, skip the gate then.
+    m_pCombinedRegex.reset();
+
+    if (m_vRegexPatterns.size() < 2)
+        return;
+
+    std::string combined;
+    for (auto& i : m_vRegexPatterns) {
+        const auto& PATTERN = m_vPatterns[i].szPattern;
+
+        for (size_t j = 0; j + 1 < PATTERN.length(); ++j) {
+            if (PATTERN[j] == '\\' && std::isdigit((unsigned char)PATTERN[j + 1]))
+                return;
+        }
+
+        combined += (combined.empty() ? "(?:" : "|(?:") + PATTERN + ")";
+    }
+
+    m_pCombinedRegex = std::make_unique<std::regex>(combined, std::regex::optimize);
+}
+
+void CMultiPatternMatcher::match(const std::string& str, std::vector<bool>& matches) const {
+    matches.assign(m_vPatterns.size(), false);
+
+    uint32_t node = 0;
+    for (const unsigned char c : str) {
+        int64_t next = edge(node, c);
+
+        while (next == -1 && node != 0) {
+            node = m_vNodes[node].iFail;
+            next = edge(node, c);
+        }
+
+        node = next == -1 ? 0 : next;
+
+        for (auto& i : m_vNodes[node].vOutputs)
+            matches[i] = true;
+    }
+
+    if (m_vRegexPatterns.empty() || (m_pCombinedRegex && !std::regex_search(str, *m_pCombinedRegex)))
+        return;
+
+    for (auto& i : m_vRegexPatterns)
+        matches[i] = std::regex_search(str, m_vPatterns[i].regex);
+}
+
+size_t CMultiPatternMatcher::size() const {
+    return m_vPatterns.size();
+}
+
+int64_t CMultiPatternMatcher::edge(uint32_t node, unsigned char c) const {
+    const auto& EDGES = m_vNodes[node].vEdges;
+    const auto  IT    = std::lower_bound(EDGES.begin(), EDGES.end(), std::make_pair(c, (uint32_t)0));
+
+    return IT != EDGES.end() && IT->first == c ? (int64_t)IT->second : -1;
+}
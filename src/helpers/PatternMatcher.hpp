@@ -0,0 +1,46 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <regex>
+#include <memory>
+#include <cstdint>
+
+// Checks a string against a whole set of patterns in about one pass, instead of pattern by pattern.
+// Literal patterns (no regex syntax) share one Aho-Corasick automaton, regexes are gated by a single
+// alternation of all of them, so the individual regexes only run when at least one of them can match.
+class CMultiPatternMatcher {
+public:
+    void        clear();
+
+    // Index of the pattern is the order it was added in. Throws std::regex_error on a bad regex.
+    size_t      add(const std::string& pattern);
+
+    // Call after the last add, before matching.
+    void        compile();
+
+    // matches[i] is set for every pattern i found somewhere in str. Sized to the pattern count.
+    void        match(const std::string& str, std::vector<bool>& matches) const;
+
+    size_t      size() const;
+
+private:
+    struct SPattern {
+        std::string szPattern;
+        bool        bLiteral = false;
+        std::regex  regex;
+    };
+
+    struct SNode {
+        std::vector<std::pair<unsigned char, uint32_t>> vEdges; // sorted by char
+        uint32_t                                        iFail = 0;
+        std::vector<size_t>                             vOutputs; // literal patterns ending here, suffixes included
+    };
+
+    int64_t     edge(uint32_t node, unsigned char c) const;
+
+    std::vector<SPattern>       m_vPatterns;
+    std::vector<size_t>         m_vRegexPatterns;
+    std::vector<SNode>          m_vNodes = {SNode()}; // 0 is the root
+    std::unique_ptr<std::regex> m_pCombinedRegex;     // nullptr when there's nothing to gate
+};
@@ -0,0 +1,137 @@
+#include "SpatialIndex.hpp"
+#include "../Compositor.hpp"
+#include <algorithm>
+#include <cmath>
+
+constexpr int CELLSIZE = 256;
+constexpr int MAXCELLSPERAXIS = 32;
+
+static int cellOf(int coord) {
+    return (int)std::floor((double)coord / CELLSIZE);
+}
+
+static uint64_t cellKey(int x, int y) {
+    return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
+
+static wlr_box realBox(CWindow* pWindow) {
+    return {(int)pWindow->m_vRealPosition.x, (int)pWindow->m_vRealPosition.y, (int)pWindow->m_vRealSize.x, (int)pWindow->m_vRealSize.y};
+}
+
+static wlr_box layoutBox(CWindow* pWindow) {
+    return {(int)pWindow->m_vPosition.x, (int)pWindow->m_vPosition.y, (int)pWindow->m_vSize.x, (int)pWindow->m_vSize.y};
+}
+
+// calls fn with the cell list (or the oversized list) every cell the box touches
+template <typename F>
+static void forEachBucket(std::unordered_map<uint64_t, std::vector<uint32_t>>& cells, std::vector<uint32_t>& oversized, const wlr_box& box, bool create, F&& fn) {
+    if (box.width <= 0 || box.height <= 0)
+        return;
+
+    const int X1 = cellOf(box.x);
+    const int Y1 = cellOf(box.y);
+    const int X2 = cellOf(box.x + box.width - 1);
+    const int Y2 = cellOf(box.y + box.height - 1);
+
+    if (X2 - X1 >= MAXCELLSPERAXIS || Y2 - Y1 >= MAXCELLSPERAXIS) {
+        fn(oversized, 0);
+        return;
+    }
+
+    for (int x = X1; x <= X2; ++x) {
+        for (int y = Y1; y <= Y2; ++y) {
+            const auto KEY = cellKey(x, y);
+
+            if (create) {
+                fn(cells[KEY], KEY);
+            } else if (const auto IT = cells.find(KEY); IT != cells.end()) {
+                fn(IT->second, KEY);
+            }
+        }
+    }
+}
+
+void CWindowSpatialIndex::insert(SGrid& grid, uint32_t idx) {
+    forEachBucket(grid.mCells, grid.vOversized, grid.vEntries[idx].box, true, [&](std::vector<uint32_t>& bucket, uint64_t) {
+        // mostly appends, only windows that moved land in the middle
+        bucket.insert(std::lower_bound(bucket.begin(), bucket.end(), idx), idx);
+    });
+}
+
+void CWindowSpatialIndex::remove(SGrid& grid, uint32_t idx) {
+    std::vector<uint64_t> emptied;
+
+    forEachBucket(grid.mCells, grid.vOversized, grid.vEntries[idx].box, false, [&](std::vector<uint32_t>& bucket, uint64_t key) {
+        const auto IT = std::lower_bound(bucket.begin(), bucket.end(), idx);
+        if (IT != bucket.end() && *IT == idx)
+            bucket.erase(IT);
+
+        if (bucket.empty() && &bucket != &grid.vOversized)
+            emptied.push_back(key);
+    });
+
+    for (auto& key : emptied)
+        grid.mCells.erase(key);
+}
+
+const std::vector<uint32_t>* CWindowSpatialIndex::findCell(const SGrid& grid, const Vector2D& pos) const {
+    const auto IT = grid.mCells.find(cellKey(cellOf((int)std::floor(pos.x)), cellOf((int)std::floor(pos.y))));
+    return IT == grid.mCells.end() ? nullptr : &IT->second;
+}
+
+void CWindowSpatialIndex::rebuildIfNeeded() {
+    if (m_iBuiltForEpoch == g_pCompositor->m_iSceneEpoch)
+        return;
+
+    m_iBuiltForEpoch = g_pCompositor->m_iSceneEpoch;
+
+    m_vVisibleWorkspaces.clear();
+    for (auto& m : g_pCompositor->m_lMonitors)
+        m_vVisibleWorkspaces.push_back(m.activeWorkspace);
+
+    for (auto GRID : {&m_sRealGrid, &m_sLayoutGrid}) {
+        GRID->vEntries.clear();
+        GRID->mCells.clear();
+        GRID->vOversized.clear();
+    }
+
+    m_mEntryOf.clear();
+
+    for (auto& w : g_pCompositor->m_lWindows) {
+        if (std::find(m_vVisibleWorkspaces.begin(), m_vVisibleWorkspaces.end(), w.m_iWorkspaceID) == m_vVisibleWorkspaces.end())
+            continue;
+
+        const uint32_t IDX = m_sRealGrid.vEntries.size();
+        m_mEntryOf[&w] = IDX;
+
+        m_sRealGrid.vEntries.push_back({&w, realBox(&w)});
+        m_sLayoutGrid.vEntries.push_back({&w, layoutBox(&w)});
+
+        insert(m_sRealGrid, IDX);
+        insert(m_sLayoutGrid, IDX);
+    }
+}
+
+void CWindowSpatialIndex::windowMoved(CWindow* pWindow) {
+    // a stale index gets rebuilt whole on the next query anyway
+    if (m_iBuiltForEpoch != g_pCompositor->m_iSceneEpoch)
+        return;
+
+    const auto IT = m_mEntryOf.find(pWindow);
+
+    if (IT == m_mEntryOf.end())
+        return;  // not on a visible workspace
+
+    const auto IDX = IT->second;
+
+    for (auto& [GRID, BOX] : {std::pair{&m_sRealGrid, realBox(pWindow)}, std::pair{&m_sLayoutGrid, layoutBox(pWindow)}}) {
+        auto& entry = GRID->vEntries[IDX];
+
+        if (entry.box.x == BOX.x && entry.box.y == BOX.y && entry.box.width == BOX.width && entry.box.height == BOX.height)
+            continue;
+
+        remove(*GRID, IDX);
+        entry.box = BOX;
+        insert(*GRID, IDX);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../defines.hpp"
+#include <vector>
+#include <unordered_map>
+
+class CWindow;
+
+// Uniform grid over layout space for pointer hit-testing.
+// Holds the windows on visible workspaces, bottom->top like m_lWindows, bucketed twice:
+// by their real (on-screen, mid-animation) box and by their layout box.
+// It is rebuilt lazily on the first query after the compositor's scene epoch moved on,
+// a window that only moved has just its own cells updated (windowMoved).
+class CWindowSpatialIndex {
+public:
+    // topmost window whose box contains the point and passes the filter
+    template <typename F>
+    CWindow*    windowAt(const Vector2D& pos, bool realGeometry, F&& filter) {
+        rebuildIfNeeded();
+
+        const auto& GRID = realGeometry ? m_sRealGrid : m_sLayoutGrid;
+
+        const auto MATCHES = [&](uint32_t idx) {
+            const auto& ENTRY = GRID.vEntries[idx];
+            return wlr_box_contains_point(&ENTRY.box, pos.x, pos.y) && filter(ENTRY.pWindow);
+        };
+
+        int64_t best = -1;
+
+        if (const auto PCELL = findCell(GRID, pos)) {
+            for (auto it = PCELL->rbegin(); it != PCELL->rend(); ++it) {
+                if (MATCHES(*it)) {
+                    best = *it;
+                    break;
+                }
+            }
+        }
+
+        for (auto it = GRID.vOversized.rbegin(); it != GRID.vOversized.rend() && (int64_t)*it > best; ++it) {
+            if (MATCHES(*it)) {
+                best = *it;
+                break;
+            }
+        }
+
+        return best == -1 ? nullptr : GRID.vEntries[best].pWindow;
+    }
+
+    // re-buckets just this window from its current boxes
+    void        windowMoved(CWindow*);
+
+private:
+    struct SEntry {
+        CWindow*    pWindow = nullptr;
+        wlr_box     box;
+    };
+
+    struct SGrid {
+        std::vector<SEntry>                                     vEntries;
+        std::unordered_map<uint64_t, std::vector<uint32_t>>     mCells; // entry indices, ascending
+        std::vector<uint32_t>                                   vOversized; // boxes spanning too many cells to bucket, ascending
+    };
+
+    void        rebuildIfNeeded();
+    void        insert(SGrid&, uint32_t idx);
+    void        remove(SGrid&, uint32_t idx);
+    const std::vector<uint32_t>* findCell(const SGrid&, const Vector2D&) const;
+
+    uint64_t            m_iBuiltForEpoch = UINT64_MAX;
+    std::vector<int>    m_vVisibleWorkspaces;
+    std::unordered_map<CWindow*, uint32_t> m_mEntryOf; // same index in both grids
+
+    SGrid               m_sRealGrid;
+    SGrid               m_sLayoutGrid;
+};
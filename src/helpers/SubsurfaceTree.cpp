@@ -70,7 +70,7 @@ void SubsurfaceTree::destroySurfaceTree(SSurfaceTreeNode* pNode) {
     }
 
     if (!exists) {
-	    Debug::log(ERR, "Tried to remove a SurfaceTreeNode that doesn't exist?? (Node %x)", pNode);
+	    DEBUGLOG(ERR, "Tried to remove a SurfaceTreeNode that doesn't exist?? (Node %x)", pNode);
 	    return;
     }
 
@@ -85,7 +85,7 @@ void SubsurfaceTree::destroySurfaceTree(SSurfaceTreeNode* pNode) {
 
     surfaceTreeNodes.remove(*pNode);
 
-    Debug::log(LOG, "SurfaceTree Node removed");
+    DEBUGLOG(LOG, "SurfaceTree Node removed");
 }
 
 void destroySubsurface(SSubsurface* pSubsurface) {
@@ -111,7 +111,7 @@ void Events::listener_newSubsurfaceNode(void* owner, void* data) {
     pNode->childSubsurfaces.push_back(SSubsurface());
     const auto PNEWSUBSURFACE = &pNode->childSubsurfaces.back();
 
-    Debug::log(LOG, "Added a new subsurface %x", PSUBSURFACE);
+    DEBUGLOG(LOG, "Added a new subsurface %x", PSUBSURFACE);
 
     PNEWSUBSURFACE->pSubsurface = PSUBSURFACE;
     PNEWSUBSURFACE->pParent = pNode;
@@ -132,15 +132,21 @@ void Events::listener_newSubsurfaceNode(void* owner, void* data) {
 void Events::listener_mapSubsurface(void* owner, void* data) {
     SSubsurface* subsurface = (SSubsurface*)owner;
 
-    Debug::log(LOG, "Subsurface %x mapped", subsurface->pSubsurface);
+    DEBUGLOG(LOG, "Subsurface %x mapped", subsurface->pSubsurface);
 
     subsurface->pChild = createSubsurfaceNode(subsurface->pParent, subsurface, subsurface->pSubsurface->surface);
+
+    // part of a window if its parent is
+    if (const auto PWINDOW = g_pCompositor->getWindowFromSurface(subsurface->pParent->pSurface))
+        g_pCompositor->indexSurfaceTree(subsurface->pSubsurface->surface, PWINDOW);
 }
 
 void Events::listener_unmapSubsurface(void* owner, void* data) {
     SSubsurface* subsurface = (SSubsurface*)owner;
 
-    Debug::log(LOG, "Subsurface %x unmapped", subsurface);
+    DEBUGLOG(LOG, "Subsurface %x unmapped", subsurface);
+
+    g_pCompositor->unindexSurfaceTree(subsurface->pSubsurface->surface);
 
     if (subsurface->pChild) {
         const auto PNODE = subsurface->pChild;
@@ -175,7 +181,7 @@ void Events::listener_destroySubsurface(void* owner, void* data) {
     if (subsurface->pChild)
         listener_destroySubsurfaceNode(subsurface->pChild, nullptr);
 
-    Debug::log(LOG, "Subsurface %x destroyed", subsurface);
+    DEBUGLOG(LOG, "Subsurface %x destroyed", subsurface);
 
     subsurface->hyprListener_destroy.removeCallback();
     subsurface->hyprListener_map.removeCallback();
@@ -187,7 +193,7 @@ void Events::listener_destroySubsurface(void* owner, void* data) {
 void Events::listener_destroySubsurfaceNode(void* owner, void* data) {
     SSurfaceTreeNode* pNode = (SSurfaceTreeNode*)owner;
 
-    Debug::log(LOG, "Subsurface Node %x destroyed", pNode);
+    DEBUGLOG(LOG, "Subsurface Node %x destroyed", pNode);
 
     for (auto& c : pNode->childSubsurfaces)
         destroySubsurface(&c);
@@ -27,11 +27,11 @@ class Vector2D {
         return Vector2D(this->x / a, this->y / a);
     }
 
-    bool operator==(const Vector2D& a) {
+    bool operator==(const Vector2D& a) const {
         return a.x == x && a.y == y;
     }
 
-    bool operator!=(const Vector2D& a) {
+    bool operator!=(const Vector2D& a) const {
         return a.x != x || a.y != y;
     }
 
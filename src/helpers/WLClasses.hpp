@@ -5,6 +5,7 @@
 #include "../../wlr-layer-shell-unstable-v1-protocol.h"
 #include "../Window.hpp"
 #include "SubsurfaceTree.hpp"
+#include "WindowRegistry.hpp"
 
 struct SLayerSurface {
     wlr_layer_surface_v1*   layerSurface;
@@ -48,6 +49,9 @@ struct SRenderData {
 
     // for alpha settings
     float alpha = 1.f;
+
+    // for blur, windows directly on the background can use the cached one
+    bool cachedBlur = false;
 };
 
 struct SKeyboard {
@@ -92,7 +96,7 @@ struct SConstraint {
 struct SMonitor;
 
 struct SXDGPopup {
-    CWindow*        parentWindow = nullptr;
+    SWindowHandle   parentWindow;
     SXDGPopup*      parentPopup = nullptr;
     wlr_xdg_popup*  popup = nullptr;
     SMonitor*       monitor = nullptr;
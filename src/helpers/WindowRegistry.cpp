@@ -0,0 +1,71 @@
+#include "WindowRegistry.hpp"
+#include "../Compositor.hpp"
+
+CWindowHandle::CWindowHandle(CWindow* pWindow) {
+    *this = pWindow;
+}
+
+CWindowHandle& CWindowHandle::operator=(CWindow* pWindow) {
+    m_sHandle = pWindow ? g_pCompositor->m_WindowRegistry.handleOf(pWindow) : SWindowHandle();
+    return *this;
+}
+
+CWindow* CWindowHandle::get() const {
+    return g_pCompositor->m_WindowRegistry.get(m_sHandle);
+}
+
+SWindowHandle CWindowRegistry::add(CWindow* pWindow) {
+    if (const auto IT = m_mSlotForWindow.find(pWindow); IT != m_mSlotForWindow.end())
+        return SWindowHandle{IT->second, m_vSlots[IT->second].generation};
+
+    uint32_t slot = 0;
+
+    if (!m_vFreeSlots.empty()) {
+        slot = m_vFreeSlots.back();
+        m_vFreeSlots.pop_back();
+    } else {
+        slot = m_vSlots.size();
+        m_vSlots.push_back(SSlot());
+    }
+
+    m_vSlots[slot].pWindow = pWindow;
+    m_mSlotForWindow[pWindow] = slot;
+
+    return SWindowHandle{slot, m_vSlots[slot].generation};
+}
+
+void CWindowRegistry::remove(CWindow* pWindow) {
+    const auto IT = m_mSlotForWindow.find(pWindow);
+
+    if (IT == m_mSlotForWindow.end())
+        return;
+
+    auto& SLOT = m_vSlots[IT->second];
+    SLOT.pWindow = nullptr;
+    SLOT.generation++; // invalidates every handle given out for this slot
+
+    m_vFreeSlots.push_back(IT->second);
+    m_mSlotForWindow.erase(IT);
+}
+
+CWindow* CWindowRegistry::get(const SWindowHandle& handle) const {
+    if (handle.slot >= m_vSlots.size())
+        return nullptr;
+
+    const auto& SLOT = m_vSlots[handle.slot];
+
+    return SLOT.generation == handle.generation ? SLOT.pWindow : nullptr;
+}
+
+SWindowHandle CWindowRegistry::handleOf(CWindow* pWindow) {
+    const auto IT = m_mSlotForWindow.find(pWindow);
+
+    if (IT == m_mSlotForWindow.end())
+        return SWindowHandle();
+
+    return SWindowHandle{IT->second, m_vSlots[IT->second].generation};
+}
+
+bool CWindowRegistry::contains(CWindow* pWindow) {
+    return m_mSlotForWindow.contains(pWindow);
+}
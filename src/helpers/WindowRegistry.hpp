@@ -0,0 +1,61 @@
+#pragma once
+
+#include "../defines.hpp"
+#include <vector>
+#include <unordered_map>
+
+class CWindow;
+
+// A handle to a window that can be checked for validity in O(1).
+// The slot's generation is bumped when the window goes away, so old handles simply stop resolving.
+struct SWindowHandle {
+    uint32_t    slot = UINT32_MAX;
+    uint32_t    generation = 0;
+
+    bool operator==(const SWindowHandle& rhs) const {
+        return slot == rhs.slot && generation == rhs.generation;
+    }
+};
+
+// For things that hold on to a window for longer than a call (focus, layout nodes).
+// Reads like a CWindow*, but goes through the registry every time, so a window that's gone reads as nullptr instead of dangling.
+class CWindowHandle {
+public:
+    CWindowHandle() = default;
+    explicit CWindowHandle(CWindow*);
+
+    CWindowHandle&  operator=(CWindow*);
+
+    CWindow*        get() const;
+
+    operator CWindow*() const {
+        return get();
+    }
+
+    CWindow*        operator->() const {
+        return get();
+    }
+
+private:
+    SWindowHandle   m_sHandle;
+};
+
+class CWindowRegistry {
+public:
+    SWindowHandle   add(CWindow*);
+    void            remove(CWindow*);
+
+    CWindow*        get(const SWindowHandle&) const;
+    SWindowHandle   handleOf(CWindow*);
+    bool            contains(CWindow*);
+
+private:
+    struct SSlot {
+        CWindow*    pWindow = nullptr;
+        uint32_t    generation = 0;
+    };
+
+    std::vector<SSlot>                      m_vSlots;
+    std::vector<uint32_t>                   m_vFreeSlots;
+    std::unordered_map<CWindow*, uint32_t>  m_mSlotForWindow;
+};
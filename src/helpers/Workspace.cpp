@@ -5,7 +5,7 @@ CWorkspace::CWorkspace(int monitorID) {
     const auto PMONITOR = g_pCompositor->getMonitorFromID(monitorID);
 
     if (!PMONITOR) {
-        Debug::log(ERR, "Attempted a creation of CWorkspace with an invalid monitor?");
+        DEBUGLOG(ERR, "Attempted a creation of CWorkspace with an invalid monitor?");
         return;
     }
 
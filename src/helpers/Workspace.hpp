@@ -1,6 +1,9 @@
 #pragma once
 
 #include "../defines.hpp"
+#include <vector>
+
+class CWindow;
 
 class CWorkspace {
 public:
@@ -14,4 +17,11 @@ public:
     wlr_ext_workspace_handle_v1* m_pWlrHandle = nullptr;
 
     wl_array        m_wlrCoordinateArr;
-};
\ No newline at end of file
+};
+
+// The windows assigned to a workspace, in m_lWindows order, and how many of them are mapped.
+// Kept by CCompositor::setWindowWorkspace / setWindowMapped so lookups don't walk every window.
+struct SWorkspaceWindows {
+    std::vector<CWindow*>   windows;
+    int                     mappedCount = 0;
+};
@@ -81,6 +81,10 @@ void CHyprError::createQueued() {
     m_cQueued = CColor();
 }
 
+bool CHyprError::active() {
+    return m_bIsCreated || m_szQueued != "";
+}
+
 void CHyprError::draw() {
     if (!m_bIsCreated || m_szQueued != "") {
         if (m_szQueued != "")
@@ -91,7 +91,7 @@ void CHyprDwindleLayout::applyNodeDataToWindow(SDwindleNodeData* pNode) {
     const auto PMONITOR = g_pCompositor->getMonitorFromID(g_pCompositor->getWorkspaceByID(pNode->workspaceID)->m_iMonitorID);
 
     if (!PMONITOR){
-        Debug::log(ERR, "Orphaned Node %x (workspace ID: %i)!!", pNode, pNode->workspaceID);
+        DEBUGLOG(ERR, "Orphaned Node %x (workspace ID: %i)!!", pNode, pNode->workspaceID);
         return;
     }
 
@@ -105,19 +105,24 @@ void CHyprDwindleLayout::applyNodeDataToWindow(SDwindleNodeData* pNode) {
     const bool DISPLAYTOP           = STICKS(pNode->position.y, PMONITOR->vecPosition.y + PMONITOR->vecReservedTopLeft.y);
     const bool DISPLAYBOTTOM        = STICKS(pNode->position.y + pNode->size.y, PMONITOR->vecPosition.y + PMONITOR->vecSize.y - PMONITOR->vecReservedBottomRight.y);
 
-    const auto BORDERSIZE           = g_pConfigManager->getInt("general:border_size");
-    const auto GAPSIN               = g_pConfigManager->getInt("general:gaps_in");
-    const auto GAPSOUT              = g_pConfigManager->getInt("general:gaps_out");
+    static const CConfigHandle<int64_t> BORDERSIZEHANDLE("general:border_size");
+    static const CConfigHandle<int64_t> GAPSINHANDLE("general:gaps_in");
+    static const CConfigHandle<int64_t> GAPSOUTHANDLE("general:gaps_out");
 
-    const auto PWINDOW = pNode->pWindow;
+    const auto BORDERSIZE           = *BORDERSIZEHANDLE;
+    const auto GAPSIN               = *GAPSINHANDLE;
+    const auto GAPSOUT              = *GAPSOUTHANDLE;
+
+    const auto PWINDOW = pNode->pWindow.get();
 
     if (!g_pCompositor->windowValidMapped(PWINDOW)) {
-        Debug::log(ERR, "Node %x holding invalid window %x!!", pNode, PWINDOW);
+        DEBUGLOG(ERR, "Node %x holding invalid window %x!!", pNode, PWINDOW);
         return;
     }
 
     PWINDOW->m_vSize = pNode->size;
     PWINDOW->m_vPosition = pNode->position;
+    g_pCompositor->windowGeometryChanged(PWINDOW);
 
     PWINDOW->m_vEffectivePosition = PWINDOW->m_vPosition + Vector2D(BORDERSIZE, BORDERSIZE);
     PWINDOW->m_vEffectiveSize = PWINDOW->m_vSize - Vector2D(2 * BORDERSIZE, 2 * BORDERSIZE);
@@ -181,7 +186,7 @@ void CHyprDwindleLayout::onWindowCreated(CWindow* pWindow) {
     else
         OPENINGON = getFirstNodeOnWorkspace(PMONITOR->activeWorkspace);
 
-    Debug::log(LOG, "OPENINGON: %x, Workspace: %i, Monitor: %i", OPENINGON, PNODE->workspaceID, PMONITOR->ID);
+    DEBUGLOG(LOG, "OPENINGON: %x, Workspace: %i, Monitor: %i", OPENINGON, PNODE->workspaceID, PMONITOR->ID);
 
     // if it's the first, it's easy. Make it fullscreen.
     if (!OPENINGON || OPENINGON->pWindow == pWindow) {
@@ -192,6 +197,7 @@ void CHyprDwindleLayout::onWindowCreated(CWindow* pWindow) {
 
         pWindow->m_vRealPosition = PNODE->position + PNODE->size / 2.f;
         pWindow->m_vRealSize = Vector2D(5, 5);
+        g_pCompositor->windowGeometryChanged(pWindow);
 
         return;
     }
@@ -267,6 +273,7 @@ void CHyprDwindleLayout::onWindowCreated(CWindow* pWindow) {
 
     pWindow->m_vRealPosition = PNODE->position + PNODE->size / 2.f;
     pWindow->m_vRealSize = Vector2D(5,5);
+    g_pCompositor->windowGeometryChanged(pWindow);
 }
 
 void CHyprDwindleLayout::onWindowRemoved(CWindow* pWindow) {
@@ -348,12 +355,14 @@ void CHyprDwindleLayout::recalculateMonitor(const int& monid) {
         TOPNODE->size = PMONITOR->vecSize - PMONITOR->vecReservedTopLeft - PMONITOR->vecReservedBottomRight;
         TOPNODE->recalcSizePosRecursive();
     }
+
+    g_pCompositor->sceneChanged();
 }
 
 void CHyprDwindleLayout::changeWindowFloatingMode(CWindow* pWindow) {
 
     if (pWindow->m_bIsFullscreen) {
-        Debug::log(LOG, "Rejecting a change float order because window is fullscreen.");
+        DEBUGLOG(LOG, "Rejecting a change float order because window is fullscreen.");
 
         // restore its' floating mode
         pWindow->m_bIsFloating = !pWindow->m_bIsFloating;
@@ -379,22 +388,24 @@ void CHyprDwindleLayout::changeWindowFloatingMode(CWindow* pWindow) {
 
         g_pCompositor->moveWindowToTop(pWindow);
     }
+
+    g_pCompositor->sceneChanged();
 }
 
 void CHyprDwindleLayout::onBeginDragWindow() {
 
-    const auto DRAGGINGWINDOW = g_pInputManager->currentlyDraggedWindow;
+    const auto DRAGGINGWINDOW = g_pCompositor->m_WindowRegistry.get(g_pInputManager->currentlyDraggedWindow);
 
     m_vBeginDragSizeXY = Vector2D();
 
     // Window will be floating. Let's check if it's valid. It should be, but I don't like crashing.
     if (!g_pCompositor->windowValidMapped(DRAGGINGWINDOW)) {
-        Debug::log(ERR, "Dragging attempted on an invalid window!");
+        DEBUGLOG(ERR, "Dragging attempted on an invalid window!");
         return;
     }
 
     if (DRAGGINGWINDOW->m_bIsFullscreen) {
-	    Debug::log(LOG, "Rejecting drag on a fullscreen window.");
+	    DEBUGLOG(LOG, "Rejecting drag on a fullscreen window.");
 	    return;
     }
 
@@ -417,7 +428,11 @@ void CHyprDwindleLayout::onBeginDragWindow() {
 }
 
 void CHyprDwindleLayout::onEndDragWindow() {
-    const auto DRAGGINGWINDOW = g_pInputManager->currentlyDraggedWindow;
+    const auto DRAGGINGWINDOW = g_pCompositor->m_WindowRegistry.get(g_pInputManager->currentlyDraggedWindow);
+
+    // the window may have been closed mid-drag, in which case the handle no longer resolves
+    if (!DRAGGINGWINDOW)
+        return;
 
     if (DRAGGINGWINDOW->m_bDraggingTiled) {
         DRAGGINGWINDOW->m_bIsFloating = false;
@@ -428,7 +443,7 @@ void CHyprDwindleLayout::onEndDragWindow() {
 }
 
 void CHyprDwindleLayout::onMouseMove(const Vector2D& mousePos) {
-    const auto DRAGGINGWINDOW = g_pInputManager->currentlyDraggedWindow;
+    const auto DRAGGINGWINDOW = g_pCompositor->m_WindowRegistry.get(g_pInputManager->currentlyDraggedWindow);
 
     // Window invalid or drag begin size 0,0 meaning we rejected it.
     if (!g_pCompositor->windowValidMapped(DRAGGINGWINDOW) || m_vBeginDragSizeXY == Vector2D())
@@ -447,12 +462,14 @@ void CHyprDwindleLayout::onMouseMove(const Vector2D& mousePos) {
     if (g_pInputManager->dragButton == BTN_LEFT) {
         DRAGGINGWINDOW->m_vRealPosition = m_vBeginDragPositionXY + DELTA;
         DRAGGINGWINDOW->m_vEffectivePosition = DRAGGINGWINDOW->m_vRealPosition;
+        g_pCompositor->windowGeometryChanged(DRAGGINGWINDOW);
     } else {
         if (DRAGGINGWINDOW->m_bIsFloating) {
             DRAGGINGWINDOW->m_vRealSize = m_vBeginDragSizeXY + DELTA;
             DRAGGINGWINDOW->m_vRealSize = Vector2D(std::clamp(DRAGGINGWINDOW->m_vRealSize.x, (double)20, (double)999999), std::clamp(DRAGGINGWINDOW->m_vRealSize.y, (double)20, (double)999999));
 
             DRAGGINGWINDOW->m_vEffectiveSize = DRAGGINGWINDOW->m_vRealSize;
+            g_pCompositor->windowGeometryChanged(DRAGGINGWINDOW);
 
             g_pXWaylandManager->setWindowSize(DRAGGINGWINDOW, DRAGGINGWINDOW->m_vRealSize);
         } else {
@@ -522,7 +539,7 @@ void CHyprDwindleLayout::onMouseMove(const Vector2D& mousePos) {
 
     if (PMONITOR) {
         DRAGGINGWINDOW->m_iMonitorID = PMONITOR->ID;
-        DRAGGINGWINDOW->m_iWorkspaceID = PMONITOR->activeWorkspace;
+        g_pCompositor->setWindowWorkspace(DRAGGINGWINDOW, PMONITOR->activeWorkspace);
     }
 
     g_pHyprRenderer->damageWindow(DRAGGINGWINDOW);
@@ -534,7 +551,7 @@ void CHyprDwindleLayout::onWindowCreatedFloating(CWindow* pWindow) {
     const auto PMONITOR = g_pCompositor->getMonitorFromID(pWindow->m_iMonitorID);
 
     if (!PMONITOR){
-        Debug::log(ERR, "Window %x (%s) has an invalid monitor in onWindowCreatedFloating!!!", pWindow, pWindow->m_szTitle.c_str());
+        DEBUGLOG(ERR, "Window %x (%s) has an invalid monitor in onWindowCreatedFloating!!!", pWindow, pWindow->m_szTitle.c_str());
         return;
     }
 
@@ -569,6 +586,8 @@ void CHyprDwindleLayout::onWindowCreatedFloating(CWindow* pWindow) {
         pWindow->m_vRealSize = pWindow->m_vEffectiveSize;
     }
 
+    g_pCompositor->windowGeometryChanged(pWindow);
+
     g_pXWaylandManager->setWindowSize(pWindow, pWindow->m_vRealSize);
     g_pCompositor->fixXWaylandWindowsOnWorkspace(PMONITOR->activeWorkspace);
 
@@ -592,6 +611,8 @@ void CHyprDwindleLayout::fullscreenRequestForWindow(CWindow* pWindow) {
     pWindow->m_bIsFullscreen = !pWindow->m_bIsFullscreen;
     PWORKSPACE->m_bHasFullscreenWindow = !PWORKSPACE->m_bHasFullscreenWindow;
 
+    g_pEventManager->postEvent(SHyprIPCEvent{"fullscreen", pWindow->m_bIsFullscreen ? "1" : "0"});
+
     if (!pWindow->m_bIsFullscreen) {
         // if it got its fullscreen disabled, set back its node if it had one
         const auto PNODE = getNodeFromWindow(pWindow);
@@ -621,6 +642,7 @@ void CHyprDwindleLayout::fullscreenRequestForWindow(CWindow* pWindow) {
     }
 
     g_pCompositor->moveWindowToTop(pWindow);
+    g_pCompositor->sceneChanged();
 
     // we need to fix XWayland windows by sending them to NARNIA
     // because otherwise they'd still be recieving mouse events
@@ -717,12 +739,15 @@ SWindowRenderLayoutHints CHyprDwindleLayout::requestRenderHints(CWindow* pWindow
         return hints; // left for the future, maybe floating funkiness
 
     if (PNODE->pGroupParent) {
+        static const CConfigHandle<int64_t> GROUPBORDERACTIVE("dwindle:col.group_border_active");
+        static const CConfigHandle<int64_t> GROUPBORDER("dwindle:col.group_border");
+
         hints.isBorderColor = true;
 
         if (pWindow == g_pCompositor->m_pLastWindow)
-            hints.borderColor = CColor(g_pConfigManager->getInt("dwindle:col.group_border_active"));
+            hints.borderColor = CColor(*GROUPBORDERACTIVE);
         else
-            hints.borderColor = CColor(g_pConfigManager->getInt("dwindle:col.group_border"));
+            hints.borderColor = CColor(*GROUPBORDER);
     }
 
     return hints;
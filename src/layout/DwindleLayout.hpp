@@ -3,6 +3,7 @@
 #include "IHyprLayout.hpp"
 #include <list>
 #include <deque>
+#include "../helpers/WindowRegistry.hpp"
 
 class CHyprDwindleLayout;
 
@@ -10,7 +11,7 @@ struct SDwindleNodeData {
     SDwindleNodeData* pParent = nullptr;
     bool            isNode = false;
 
-    CWindow*        pWindow = nullptr;
+    CWindowHandle   pWindow;
 
     std::array<SDwindleNodeData*, 2> children = { nullptr, nullptr };
 
@@ -28,7 +29,7 @@ struct SDwindleNodeData {
 
     // For list lookup
     bool operator==(const SDwindleNodeData& rhs) {
-        return pWindow == rhs.pWindow && workspaceID == rhs.workspaceID && position == rhs.position && size == rhs.size && pParent == rhs.pParent && children[0] == rhs.children[0] && children[1] == rhs.children[1];
+        return pWindow.get() == rhs.pWindow.get() && workspaceID == rhs.workspaceID && position == rhs.position && size == rhs.size && pParent == rhs.pParent && children[0] == rhs.children[0] && children[1] == rhs.children[1];
     }
 
     void            recalcSizePosRecursive();
@@ -3,25 +3,37 @@
 
 void CAnimationManager::tick() {
 
+    static const CConfigHandle<int64_t> ENABLED("animations:enabled");
+    static const CConfigHandle<int64_t> WINDOWS("animations:windows");
+    static const CConfigHandle<int64_t> BORDERS("animations:borders");
+    static const CConfigHandle<int64_t> FADEIN("animations:fadein");
+    static const CConfigHandle<float>   SPEED("animations:speed");
+    static const CConfigHandle<float>   WINDOWSSPEED("animations:windows_speed");
+    static const CConfigHandle<float>   BORDERSSPEED("animations:borders_speed");
+    static const CConfigHandle<float>   FADEINSPEED("animations:fadein_speed");
+    static const CConfigHandle<int64_t> ACTIVEBORDER("general:col.active_border");
+    static const CConfigHandle<int64_t> INACTIVEBORDER("general:col.inactive_border");
+    static const CConfigHandle<int64_t> BORDERSIZEHANDLE("general:border_size");
+
     bool animationsDisabled = false;
 
-    if (!g_pConfigManager->getInt("animations:enabled"))
+    if (!*ENABLED)
         animationsDisabled = true;
 
-    const bool WINDOWSENABLED   = g_pConfigManager->getInt("animations:windows") && !animationsDisabled;
-    const bool BORDERSENABLED   = g_pConfigManager->getInt("animations:borders") && !animationsDisabled;
-    const bool FADEENABLED      = g_pConfigManager->getInt("animations:fadein") && !animationsDisabled;
-    const float ANIMSPEED       = g_pConfigManager->getFloat("animations:speed");
+    const bool WINDOWSENABLED   = *WINDOWS && !animationsDisabled;
+    const bool BORDERSENABLED   = *BORDERS && !animationsDisabled;
+    const bool FADEENABLED      = *FADEIN && !animationsDisabled;
+    const float ANIMSPEED       = *SPEED;
 
     // Process speeds
-    const float WINDOWSPEED     = g_pConfigManager->getFloat("animations:windows_speed") == 0 ? ANIMSPEED : g_pConfigManager->getFloat("animations:windows_speed");
-    const float BORDERSPEED     = g_pConfigManager->getFloat("animations:borders_speed") == 0 ? ANIMSPEED : g_pConfigManager->getFloat("animations:borders_speed");
-    const float FADESPEED       = g_pConfigManager->getFloat("animations:fadein_speed")  == 0 ? ANIMSPEED : g_pConfigManager->getFloat("animations:fadein_speed");
+    const float WINDOWSPEED     = *WINDOWSSPEED == 0 ? ANIMSPEED : *WINDOWSSPEED;
+    const float BORDERSPEED     = *BORDERSSPEED == 0 ? ANIMSPEED : *BORDERSSPEED;
+    const float FADESPEED       = *FADEINSPEED  == 0 ? ANIMSPEED : *FADEINSPEED;
 
-    const auto BORDERACTIVECOL  = CColor(g_pConfigManager->getInt("general:col.active_border"));
-    const auto BORDERINACTIVECOL = CColor(g_pConfigManager->getInt("general:col.inactive_border"));
+    const auto BORDERACTIVECOL  = CColor(*ACTIVEBORDER);
+    const auto BORDERINACTIVECOL = CColor(*INACTIVEBORDER);
 
-    const auto BORDERSIZE       = g_pConfigManager->getInt("general:border_size");
+    const auto BORDERSIZE       = *BORDERSIZEHANDLE;
 
     for (auto& w : g_pCompositor->m_lWindows) {
 
@@ -105,13 +117,18 @@ void CAnimationManager::tick() {
                 }
 
                 needsDamage = true;
+                g_pCompositor->windowGeometryChanged(&w);
             }
         } else {
-            if (!deltazero(w.m_vRealPosition, w.m_vEffectivePosition) || !deltazero(w.m_vRealSize, w.m_vEffectiveSize))
-                needsDamage = true;
+            const bool MOVED = !deltazero(w.m_vRealPosition, w.m_vEffectivePosition) || !deltazero(w.m_vRealSize, w.m_vEffectiveSize);
 
             w.m_vRealPosition = w.m_vEffectivePosition;
             w.m_vRealSize = w.m_vEffectiveSize;
+
+            if (MOVED) {
+                needsDamage = true;
+                g_pCompositor->windowGeometryChanged(&w);
+            }
         }
 
         if (needsDamage) {
@@ -0,0 +1,160 @@
+#include "EventManager.hpp"
+#include "../Compositor.hpp"
+
+#include <algorithm>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+void CEventManager::startSocket() {
+    m_iSocketFD = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (m_iSocketFD < 0) {
+        DEBUGLOG(ERR, "Couldn't start the Hyprland event socket. (1) IPC events will not work.");
+        return;
+    }
+
+    sockaddr_un SERVERADDRESS = {.sun_family = AF_UNIX};
+    strcpy(SERVERADDRESS.sun_path, EVENT_SOCKET_PATH);
+
+    unlink(EVENT_SOCKET_PATH);
+
+    if (bind(m_iSocketFD, (sockaddr*)&SERVERADDRESS, SUN_LEN(&SERVERADDRESS)) < 0) {
+        DEBUGLOG(ERR, "Couldn't bind the Hyprland event socket (%s). (2) IPC events will not work.", strerror(errno));
+        close(m_iSocketFD);
+        m_iSocketFD = -1;
+        return;
+    }
+
+    listen(m_iSocketFD, 10);
+
+    m_pSocketSource = wl_event_loop_add_fd(wl_display_get_event_loop(g_pCompositor->m_sWLDisplay), m_iSocketFD, WL_EVENT_READABLE, [](int fd, uint32_t mask, void* data) -> int {
+        ((CEventManager*)data)->onNewConnections();
+        return 0;
+    }, this);
+
+    DEBUGLOG(LOG, "Hypr event socket started at %s", EVENT_SOCKET_PATH);
+}
+
+void CEventManager::onNewConnections() {
+    while (true) {
+        const auto ACCEPTEDCONNECTION = accept4(m_iSocketFD, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (ACCEPTEDCONNECTION < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                DEBUGLOG(ERR, "IPC events: accept failed: %s", strerror(errno));
+            break;
+        }
+
+        if (m_lClients.size() >= EVENT_MAX_CLIENTS) {
+            DEBUGLOG(WARN, "IPC events: too many clients, dropping a connection");
+            close(ACCEPTEDCONNECTION);
+            continue;
+        }
+
+        auto& client = m_lClients.emplace_back();
+        client.fd = ACCEPTEDCONNECTION;
+
+        // readable only to notice when they go away
+        client.eventSource = wl_event_loop_add_fd(wl_display_get_event_loop(g_pCompositor->m_sWLDisplay), ACCEPTEDCONNECTION, WL_EVENT_READABLE, [](int fd, uint32_t mask, void* data) -> int {
+            g_pEventManager->onClientEvent((SEventClient*)data, mask);
+            return 0;
+        }, &client);
+    }
+}
+
+void CEventManager::onClientEvent(SEventClient* pClient, uint32_t mask) {
+    if (mask & WL_EVENT_READABLE) {
+        char readBuffer[1024];
+        ssize_t len = 0;
+
+        // nothing they say matters, just drain it
+        while ((len = read(pClient->fd, readBuffer, sizeof(readBuffer))) > 0)
+            ;
+
+        if (len == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            removeClient(pClient);
+            return;
+        }
+    }
+
+    if (mask & (WL_EVENT_HANGUP | WL_EVENT_ERROR)) {
+        removeClient(pClient);
+        return;
+    }
+
+    if (mask & WL_EVENT_WRITABLE) {
+        if (!flushClient(pClient))
+            return;
+
+        if (pClient->pending.empty())
+            wl_event_source_fd_update(pClient->eventSource, WL_EVENT_READABLE);
+    }
+}
+
+bool CEventManager::flushClient(SEventClient* pClient) {
+    size_t written = 0;
+
+    while (written < pClient->pending.length()) {
+        const auto LEN = send(pClient->fd, pClient->pending.c_str() + written, pClient->pending.length() - written, MSG_NOSIGNAL);
+
+        if (LEN < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+
+            removeClient(pClient);
+            return false;
+        }
+
+        written += LEN;
+    }
+
+    pClient->pending.erase(0, written);
+    return true;
+}
+
+void CEventManager::removeClient(SEventClient* pClient) {
+    wl_event_source_remove(pClient->eventSource);
+    close(pClient->fd);
+
+    m_lClients.remove_if([&](const SEventClient& other) { return &other == pClient; });
+}
+
+void CEventManager::postEvent(const SHyprIPCEvent& event) {
+    if (m_lClients.empty())
+        return;
+
+    // data can hold titles and such straight from clients, a newline in there would let them forge events
+    std::string data = event.data;
+    std::replace_if(data.begin(), data.end(), [](char c) { return c == '\n' || c == '\r'; }, ' ');
+
+    const std::string LINE = event.event + ">>" + data + "\n";
+
+    for (auto it = m_lClients.begin(); it != m_lClients.end();) {
+        const auto PCLIENT = &*it;
+        ++it;  // flushClient might remove it
+
+        const bool WASEMPTY = PCLIENT->pending.empty();
+
+        // a client that can't keep up must not make us buffer without bounds
+        if (PCLIENT->pending.length() + LINE.length() > EVENT_CLIENT_BUFFER_MAX) {
+            DEBUGLOG(WARN, "IPC events: client %i is too slow, disconnecting it", PCLIENT->fd);
+            removeClient(PCLIENT);
+            continue;
+        }
+
+        PCLIENT->pending += LINE;
+
+        if (!WASEMPTY)
+            continue;  // already waiting for the socket to drain, keep the order
+
+        if (!flushClient(PCLIENT))
+            continue;
+
+        if (!PCLIENT->pending.empty())
+            wl_event_source_fd_update(PCLIENT->eventSource, WL_EVENT_READABLE | WL_EVENT_WRITABLE);
+    }
+}
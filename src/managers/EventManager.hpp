@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../defines.hpp"
+#include <list>
+
+#define EVENT_SOCKET_PATH "/tmp/hypr/.socket2.sock"
+#define EVENT_MAX_CLIENTS 64
+#define EVENT_CLIENT_BUFFER_MAX 65536 // a client that falls this far behind gets disconnected
+
+// Sent to subscribers as one "event>>data\n" line
+struct SHyprIPCEvent {
+    std::string event;
+    std::string data;
+};
+
+struct SEventClient {
+    int                 fd = -1;
+    wl_event_source*    eventSource = nullptr;
+    std::string         pending = "";  // what didn't fit in the socket buffer yet
+};
+
+// Pushes compositor events to whoever is connected to the event socket. Clients only listen,
+// anything they send is ignored. Everything runs on the main event loop.
+class CEventManager {
+public:
+    void                startSocket();
+
+    void                postEvent(const SHyprIPCEvent&);
+
+private:
+    int                 m_iSocketFD = -1;
+    wl_event_source*    m_pSocketSource = nullptr;
+
+    std::list<SEventClient> m_lClients;
+
+    void                onNewConnections();
+    void                onClientEvent(SEventClient*, uint32_t);
+    bool                flushClient(SEventClient*);
+    void                removeClient(SEventClient*);
+};
+
+inline std::unique_ptr<CEventManager> g_pEventManager;
@@ -2,10 +2,12 @@
 #include "../Compositor.hpp"
 
 void CInputManager::onMouseMoved(wlr_pointer_motion_event* e) {
+    static const CConfigHandle<float> SENSITIVITY("general:sensitivity");
+    static const CConfigHandle<int64_t> APPLYSENSTORAW("general:apply_sens_to_raw");
 
-    float sensitivity = g_pConfigManager->getFloat("general:sensitivity");
+    float sensitivity = *SENSITIVITY;
 
-    if (g_pConfigManager->getInt("general:apply_sens_to_raw") == 1)
+    if (*APPLYSENSTORAW == 1)
         wlr_relative_pointer_manager_v1_send_relative_motion(g_pCompositor->m_sWLRRelPointerMgr, g_pCompositor->m_sSeat.seat, (uint64_t)e->time_msec * 1000, e->delta_x * sensitivity, e->delta_y * sensitivity, e->unaccel_dx * sensitivity, e->unaccel_dy * sensitivity);
     else
         wlr_relative_pointer_manager_v1_send_relative_motion(g_pCompositor->m_sWLRRelPointerMgr, g_pCompositor->m_sSeat.seat, (uint64_t)e->time_msec * 1000, e->delta_x, e->delta_y, e->unaccel_dx, e->unaccel_dy);
@@ -117,7 +119,9 @@ void CInputManager::mouseMoveUnified(uint32_t time, bool refocus) {
     Vector2D surfaceLocal = surfacePos == Vector2D(-1337, -1337) ? surfaceCoords : Vector2D(g_pCompositor->m_sWLRCursor->x, g_pCompositor->m_sWLRCursor->y) - surfacePos;
 
     if (pFoundWindow) {
-        if (g_pConfigManager->getInt("input:follow_mouse") == 0 && !refocus) {
+        static const CConfigHandle<int64_t> FOLLOWMOUSE("input:follow_mouse");
+
+        if (*FOLLOWMOUSE == 0 && !refocus) {
             if (pFoundWindow != g_pCompositor->m_pLastWindow && g_pCompositor->windowValidMapped(g_pCompositor->m_pLastWindow) && (g_pCompositor->m_pLastWindow->m_bIsFloating != pFoundWindow->m_bIsFloating)) {
                 // enter if change floating style
                 g_pCompositor->focusWindow(pFoundWindow, foundSurface);
@@ -164,7 +168,7 @@ void CInputManager::onMouseButton(wlr_pointer_button_event* e) {
                 g_pCompositor->moveWindowToTop(g_pCompositor->m_pLastWindow);
 
             if ((e->button == BTN_LEFT || e->button == BTN_RIGHT) && wlr_keyboard_get_modifiers(PKEYBOARD) == (uint32_t)g_pConfigManager->getInt("general:main_mod_internal")) {
-                currentlyDraggedWindow = g_pCompositor->windowFromCursor();
+                currentlyDraggedWindow = g_pCompositor->m_WindowRegistry.handleOf(g_pCompositor->windowFromCursor());
                 dragButton = e->button;
 
                 g_pLayoutManager->getCurrentLayout()->onBeginDragWindow();
@@ -173,9 +177,9 @@ void CInputManager::onMouseButton(wlr_pointer_button_event* e) {
             }
             break;
         case WLR_BUTTON_RELEASED:
-            if (currentlyDraggedWindow) {
+            if (dragButton != -1) {
                 g_pLayoutManager->getCurrentLayout()->onEndDragWindow();
-                currentlyDraggedWindow = nullptr;
+                currentlyDraggedWindow = SWindowHandle();
                 dragButton = -1;
             }
             
@@ -185,7 +189,7 @@ void CInputManager::onMouseButton(wlr_pointer_button_event* e) {
     // notify app if we didnt handle it
     if (g_pCompositor->doesSeatAcceptInput(g_pCompositor->m_pLastFocus)) {
         wlr_seat_pointer_notify_button(g_pCompositor->m_sSeat.seat, e->time_msec, e->button, e->state);
-        Debug::log(LOG, "Seat notified of button %i (state %i) on surface %x", e->button, e->state, g_pCompositor->m_pLastFocus);
+        DEBUGLOG(LOG, "Seat notified of button %i (state %i) on surface %x", e->button, e->state, g_pCompositor->m_pLastFocus);
     }
         
 }
@@ -217,7 +221,7 @@ void CInputManager::newKeyboard(wlr_input_device* keyboard) {
 
     wlr_seat_set_keyboard(g_pCompositor->m_sSeat.seat, keyboard->keyboard);
 
-    Debug::log(LOG, "New keyboard created, pointers Hypr: %x and WLR: %x", PNEWKEYBOARD, keyboard);
+    DEBUGLOG(LOG, "New keyboard created, pointers Hypr: %x and WLR: %x", PNEWKEYBOARD, keyboard);
 
     setKeyboardLayout();
 }
@@ -242,7 +246,7 @@ void CInputManager::setKeyboardLayout() {
     const auto KEYMAP = xkb_keymap_new_from_names(CONTEXT, &rules, XKB_KEYMAP_COMPILE_NO_FLAGS);
 
     if (!KEYMAP) {
-        Debug::log(ERR, "Keyboard layout %s with variant %s (rules: %s, model: %s, options: %s) couldn't have been loaded.", rules.layout, rules.variant, rules.rules, rules.model, rules.options);
+        DEBUGLOG(ERR, "Keyboard layout %s with variant %s (rules: %s, model: %s, options: %s) couldn't have been loaded.", rules.layout, rules.variant, rules.rules, rules.model, rules.options);
         xkb_context_unref(CONTEXT);
         return;
     }
@@ -254,7 +258,7 @@ void CInputManager::setKeyboardLayout() {
     xkb_keymap_unref(KEYMAP);
     xkb_context_unref(CONTEXT);
 
-    Debug::log(LOG, "Set the keyboard layout to %s and variant to %s", rules.layout, rules.variant);
+    DEBUGLOG(LOG, "Set the keyboard layout to %s and variant to %s", rules.layout, rules.variant);
 }
 
 void CInputManager::newMouse(wlr_input_device* mouse) {
@@ -277,7 +281,7 @@ void CInputManager::newMouse(wlr_input_device* mouse) {
 
     g_pCompositor->m_sSeat.mouse = PMOUSE;
 
-    Debug::log(LOG, "New mouse created, pointer WLR: %x", mouse);
+    DEBUGLOG(LOG, "New mouse created, pointer WLR: %x", mouse);
 }
 
 void CInputManager::destroyKeyboard(SKeyboard* pKeyboard) {
@@ -311,7 +315,7 @@ void CInputManager::onKeyboardKey(wlr_keyboard_key_event* e, SKeyboard* pKeyboar
 
     bool found = false;
     if (e->state == WL_KEYBOARD_KEY_STATE_PRESSED) {
-        Debug::log(LOG, "Pressed key %i, with the MODMASK being %i", e->keycode, MODS);
+        DEBUGLOG(LOG, "Pressed key %i, with the MODMASK being %i", e->keycode, MODS);
 
         for (int i = 0; i < syms; ++i)
             found = g_pKeybindManager->handleKeybinds(MODS, keysyms[i]) || found;
@@ -361,7 +365,7 @@ void CInputManager::recheckConstraint(SMouse* pMouse) {
         pixman_region32_clear(&pMouse->confinedTo);
     }
 
-    Debug::log(LOG, "Constraint rechecked: %i, %i to %i, %i", PREGION->extents.x1, PREGION->extents.y1, PREGION->extents.x2, PREGION->extents.y2);
+    DEBUGLOG(LOG, "Constraint rechecked: %i, %i to %i, %i", PREGION->extents.x1, PREGION->extents.y1, PREGION->extents.x2, PREGION->extents.y2);
 }
 
 void CInputManager::constrainMouse(SMouse* pMouse, wlr_pointer_constraint_v1* constraint) {
@@ -406,7 +410,7 @@ void CInputManager::constrainMouse(SMouse* pMouse, wlr_pointer_constraint_v1* co
 
     pMouse->hyprListener_commitConstraint.initCallback(&pMouse->currentConstraint->surface->events.commit, &Events::listener_commitConstraint, pMouse, "Mouse constraint commit");
 
-    Debug::log(LOG, "Constrained mouse to %x", pMouse->currentConstraint);
+    DEBUGLOG(LOG, "Constrained mouse to %x", pMouse->currentConstraint);
 }
 
 void Events::listener_commitConstraint(void* owner, void* data) {
@@ -31,7 +31,7 @@ public:
 
 
     // for dragging floating windows
-    CWindow*        currentlyDraggedWindow = nullptr;
+    SWindowHandle   currentlyDraggedWindow;
     int             dragButton = -1;
 
     SDrag           m_sDrag;
@@ -1,7 +1,35 @@
 #include "KeybindManager.hpp"
 
+CKeybindManager::CKeybindManager() {
+    m_mDispatchers["exec"]              = [&](const SDispatcherArg& arg) { spawn(arg.raw); };
+    m_mDispatchers["killactive"]        = [&](const SDispatcherArg& arg) { killActive(arg.raw); };
+    m_mDispatchers["togglefloating"]    = [&](const SDispatcherArg& arg) { toggleActiveFloating(arg.raw); };
+    m_mDispatchers["workspace"]         = [&](const SDispatcherArg& arg) { changeworkspace(arg); };
+    m_mDispatchers["fullscreen"]        = [&](const SDispatcherArg& arg) { fullscreenActive(arg.raw); };
+    m_mDispatchers["movetoworkspace"]   = [&](const SDispatcherArg& arg) { moveActiveToWorkspace(arg); };
+    m_mDispatchers["pseudo"]            = [&](const SDispatcherArg& arg) { toggleActivePseudo(arg.raw); };
+    m_mDispatchers["movefocus"]         = [&](const SDispatcherArg& arg) { moveFocusTo(arg); };
+    m_mDispatchers["togglegroup"]       = [&](const SDispatcherArg& arg) { toggleGroup(arg.raw); };
+    m_mDispatchers["changegroupactive"] = [&](const SDispatcherArg& arg) { changeGroupActive(arg.raw); };
+}
+
+static SDispatcherArg parseDispatcherArg(const std::string& arg) {
+    SDispatcherArg parsed;
+    parsed.raw = arg;
+    parsed.relative = arg.find_first_of("+-") == 0;
+
+    try {
+        parsed.number = std::stoi(arg);
+        parsed.isNumber = true;
+    } catch (...) {
+        parsed.isNumber = false;
+    }
+
+    return parsed;
+}
+
 void CKeybindManager::addKeybind(SKeybind kb) {
-    m_dKeybinds.push_back(kb);
+    m_dStagedKeybinds.push_back(kb);
 }
 
 uint32_t CKeybindManager::stringToModMask(std::string mods) {
@@ -27,48 +55,63 @@ uint32_t CKeybindManager::stringToModMask(std::string mods) {
 }
 
 bool CKeybindManager::handleKeybinds(const uint32_t& modmask, const xkb_keysym_t& key) {
-    bool found = false;
-
     if (handleInternalKeybinds(key))
         return true;
 
     if (g_pCompositor->m_sSeat.exclusiveClient){
-        Debug::log(LOG, "Not handling keybinds due to there being an exclusive inhibited client.");
+        DEBUGLOG(LOG, "Not handling keybinds due to there being an exclusive inhibited client.");
         return false;
     }
 
+    const auto IT = m_mKeybindLookup.find(((uint64_t)modmask << 32) | key);
+
+    if (IT == m_mKeybindLookup.end())
+        return false;
+
+    for (auto& k : IT->second)
+        (*k.pDispatcher)(k.arg);
+
+    return true;
+}
+
+bool CKeybindManager::invokeDispatcher(const std::string& dispatcher, const std::string& args) {
+    const auto IT = m_mDispatchers.find(dispatcher);
+
+    if (IT == m_mDispatchers.end())
+        return false;
+
+    IT->second(parseDispatcherArg(args));
+    return true;
+}
+
+void CKeybindManager::rebuildKeybindLookup() {
+    m_mKeybindLookup.clear();
+
     for (auto& k : m_dKeybinds) {
-        if (modmask != k.modmask) 
+        const auto DISPATCHER = m_mDispatchers.find(k.handler);
+
+        if (DISPATCHER == m_mDispatchers.end()) {
+            DEBUGLOG(ERR, "Inavlid handler in a keybind! (handler %s does not exist)", k.handler.c_str());
             continue;
+        }
 
-        // oMg such performance hit!!11!
-        // this little maneouver is gonna cost us 4µs
         const auto KBKEY = xkb_keysym_from_name(k.key.c_str(), XKB_KEYSYM_CASE_INSENSITIVE);
-        const auto KBKEYUPPER = xkb_keysym_to_upper(KBKEY);
-        // small TODO: fix 0-9 keys and other modified ones with shift
-        
-        if (key != KBKEY && key != KBKEYUPPER)
-            continue;
 
-        // yes.
-        if (k.handler == "exec") { spawn(k.arg); }
-        else if (k.handler == "killactive") { killActive(k.arg); }
-        else if (k.handler == "togglefloating") { toggleActiveFloating(k.arg); }
-        else if (k.handler == "workspace") { changeworkspace(k.arg); }
-        else if (k.handler == "fullscreen") { fullscreenActive(k.arg); }
-        else if (k.handler == "movetoworkspace") { moveActiveToWorkspace(k.arg); }
-        else if (k.handler == "pseudo") { toggleActivePseudo(k.arg); }
-        else if (k.handler == "movefocus") { moveFocusTo(k.arg); }
-        else if (k.handler == "togglegroup") { toggleGroup(k.arg); }
-        else if (k.handler == "changegroupactive") { changeGroupActive(k.arg); }
-        else {
-            Debug::log(ERR, "Inavlid handler in a keybind! (handler %s does not exist)", k.handler.c_str());
+        if (KBKEY == XKB_KEY_NoSymbol) {
+            DEBUGLOG(ERR, "Invalid key in a keybind! (key %s does not exist)", k.key.c_str());
+            continue;
         }
 
-        found = true;
-    }
+        // small TODO: fix 0-9 keys and other modified ones with shift
+        const auto KBKEYUPPER = xkb_keysym_to_upper(KBKEY);
+
+        const SResolvedKeybind RESOLVED = {&DISPATCHER->second, parseDispatcherArg(k.arg)};
 
-    return found;
+        m_mKeybindLookup[((uint64_t)k.modmask << 32) | KBKEY].push_back(RESOLVED);
+
+        if (KBKEYUPPER != KBKEY)
+            m_mKeybindLookup[((uint64_t)k.modmask << 32) | KBKEYUPPER].push_back(RESOLVED);
+    }
 }
 
 bool CKeybindManager::handleInternalKeybinds(xkb_keysym_t keysym) {
@@ -90,7 +133,7 @@ bool CKeybindManager::handleInternalKeybinds(xkb_keysym_t keysym) {
 
 void CKeybindManager::spawn(std::string args) {
     args = "WAYLAND_DISPLAY=" + std::string(g_pCompositor->m_szWLDisplaySocket) + " DISPLAY=" + std::string(g_pXWaylandManager->m_sWLRXWayland->display_name) + " " + args;
-    Debug::log(LOG, "Executing %s", args.c_str());
+    DEBUGLOG(LOG, "Executing %s", args.c_str());
     if (fork() == 0) {
         execl("/bin/sh", "/bin/sh", "-c", args.c_str(), nullptr);
 
@@ -109,24 +152,39 @@ void CKeybindManager::killActive(std::string args) {
 }
 
 void CKeybindManager::clearKeybinds() {
-    m_dKeybinds.clear();
+    m_dStagedKeybinds.clear();
+}
+
+bool CKeybindManager::commitKeybinds() {
+    // most reloads don't touch the binds, keep what we have then
+    if (m_dStagedKeybinds == m_dKeybinds) {
+        m_dStagedKeybinds.clear();
+        return false;
+    }
+
+    m_dKeybinds.swap(m_dStagedKeybinds);
+    m_dStagedKeybinds.clear();
+
+    rebuildKeybindLookup();
+    return true;
 }
 
 void CKeybindManager::toggleActiveFloating(std::string args) {
-    const auto ACTIVEWINDOW = g_pCompositor->m_pLastWindow;
+    const auto ACTIVEWINDOW = g_pCompositor->m_pLastWindow.get();
 
     if (g_pCompositor->windowValidMapped(ACTIVEWINDOW)) {
         ACTIVEWINDOW->m_bIsFloating = !ACTIVEWINDOW->m_bIsFloating;
 
         ACTIVEWINDOW->m_vRealPosition = ACTIVEWINDOW->m_vRealPosition + Vector2D(5, 5);
         ACTIVEWINDOW->m_vSize = ACTIVEWINDOW->m_vRealPosition - Vector2D(10, 10);
+        g_pCompositor->windowGeometryChanged(ACTIVEWINDOW);
 
         g_pLayoutManager->getCurrentLayout()->changeWindowFloatingMode(ACTIVEWINDOW);
     }
 }
 
 void CKeybindManager::toggleActivePseudo(std::string args) {
-    const auto ACTIVEWINDOW = g_pCompositor->m_pLastWindow;
+    const auto ACTIVEWINDOW = g_pCompositor->m_pLastWindow.get();
 
     if (!g_pCompositor->windowValidMapped(ACTIVEWINDOW))
         return;
@@ -136,32 +194,15 @@ void CKeybindManager::toggleActivePseudo(std::string args) {
     g_pLayoutManager->getCurrentLayout()->recalculateWindow(ACTIVEWINDOW);
 }
 
-void CKeybindManager::changeworkspace(std::string args) {
-    int workspaceToChangeTo = 0;
-
-    if (args.find_first_of("+") == 0) {
-        try {
-            workspaceToChangeTo = g_pCompositor->m_pLastMonitor->activeWorkspace + std::stoi(args.substr(1));
-        } catch (...) {
-            Debug::log(ERR, "Invalid arg \"%s\" in changeWorkspace!", args.c_str());
-            return;
-        }
-    } else if (args.find_first_of("-") == 0) {
-        try {
-            workspaceToChangeTo = std::clamp(g_pCompositor->m_pLastMonitor->activeWorkspace - std::stoi(args.substr(1)), 1, INT_MAX);
-        } catch (...) {
-            Debug::log(ERR, "Invalid arg \"%s\" in changeWorkspace!", args.c_str());
-            return;
-        }
-    } else {
-        try {
-            workspaceToChangeTo = stoi(args);
-        } catch (...) {
-            Debug::log(ERR, "Invalid arg \"%s\" in changeWorkspace!", args.c_str());
-            return;
-        }
+void CKeybindManager::changeworkspace(const SDispatcherArg& args) {
+    if (!args.isNumber) {
+        DEBUGLOG(ERR, "Invalid arg \"%s\" in changeWorkspace!", args.raw.c_str());
+        return;
     }
 
+    // +n / -n are relative to the current one
+    const int workspaceToChangeTo = args.relative ? std::clamp(g_pCompositor->m_pLastMonitor->activeWorkspace + args.number, 1, INT_MAX) : args.number;
+
     // if it exists, we warp to it
     if (g_pCompositor->getWorkspaceByID(workspaceToChangeTo)) {
         const auto PMONITOR = g_pCompositor->getMonitorFromID(g_pCompositor->getWorkspaceByID(workspaceToChangeTo)->m_iMonitorID);
@@ -172,6 +213,7 @@ void CKeybindManager::changeworkspace(std::string args) {
 
             // change it
             PMONITOR->activeWorkspace = workspaceToChangeTo;
+            g_pCompositor->sceneChanged();
 
             // we need to move XWayland windows to narnia or otherwise they will still process our cursor and shit
             // and that'd be annoying as hell
@@ -195,11 +237,15 @@ void CKeybindManager::changeworkspace(std::string args) {
         g_pCompositor->deactivateAllWLRWorkspaces();
         wlr_ext_workspace_handle_v1_set_active(g_pCompositor->getWorkspaceByID(workspaceToChangeTo)->m_pWlrHandle, true);
 
-        Debug::log(LOG, "Changed to workspace %i", workspaceToChangeTo);
+        DEBUGLOG(LOG, "Changed to workspace %i", workspaceToChangeTo);
+
+        g_pEventManager->postEvent(SHyprIPCEvent{"workspace", std::to_string(workspaceToChangeTo)});
 
         // focus
         g_pInputManager->refocus();
 
+        g_pCompositor->sanityCheckWorkspaces();
+
         return;
     }
 
@@ -216,8 +262,10 @@ void CKeybindManager::changeworkspace(std::string args) {
 
     PWORKSPACE->m_iID = workspaceToChangeTo;
     PWORKSPACE->m_iMonitorID = PMONITOR->ID;
+    g_pCompositor->m_mWorkspaceIDs[workspaceToChangeTo] = PWORKSPACE;
     
     PMONITOR->activeWorkspace = workspaceToChangeTo;
+    g_pCompositor->sceneChanged();
 
     // we need to move XWayland windows to narnia or otherwise they will still process our cursor and shit
     // and that'd be annoying as hell
@@ -233,11 +281,15 @@ void CKeybindManager::changeworkspace(std::string args) {
     // focus (clears the last)
     g_pInputManager->refocus();
 
-    Debug::log(LOG, "Changed to workspace %i", workspaceToChangeTo);
+    DEBUGLOG(LOG, "Changed to workspace %i", workspaceToChangeTo);
+
+    g_pEventManager->postEvent(SHyprIPCEvent{"workspace", std::to_string(workspaceToChangeTo)});
+
+    g_pCompositor->sanityCheckWorkspaces();
 }
 
 void CKeybindManager::fullscreenActive(std::string args) {
-    const auto PWINDOW = g_pCompositor->m_pLastWindow;
+    const auto PWINDOW = g_pCompositor->m_pLastWindow.get();
 
     if (!g_pCompositor->windowValidMapped(PWINDOW))
         return;
@@ -253,32 +305,31 @@ void CKeybindManager::fullscreenActive(std::string args) {
     }
 }
 
-void CKeybindManager::moveActiveToWorkspace(std::string args) {
-    const auto PWINDOW = g_pCompositor->m_pLastWindow;
+void CKeybindManager::moveActiveToWorkspace(const SDispatcherArg& args) {
+    const auto PWINDOW = g_pCompositor->m_pLastWindow.get();
 
     if (!g_pCompositor->windowValidMapped(PWINDOW))
         return;
 
-    int workspaceID;
-    try {
-        workspaceID = stoi(args);
-    } catch( ... ) {
-        Debug::log(ERR, "Invalid movetoworkspace: %s", args.c_str());
+    if (!args.isNumber) {
+        DEBUGLOG(ERR, "Invalid movetoworkspace: %s", args.raw.c_str());
         return;
     }
 
+    const int workspaceID = args.number;
+
     g_pLayoutManager->getCurrentLayout()->onWindowRemoved(PWINDOW);
 
     const auto OLDWORKSPACE = g_pCompositor->getWorkspaceByID(PWINDOW->m_iWorkspaceID);
 
     // hack
-    g_pKeybindManager->changeworkspace(std::to_string(workspaceID));
+    g_pKeybindManager->changeworkspace(parseDispatcherArg(std::to_string(workspaceID)));
 
     const auto NEWWORKSPACE = g_pCompositor->getWorkspaceByID(workspaceID);
 
     OLDWORKSPACE->m_bHasFullscreenWindow = false;
 
-    PWINDOW->m_iWorkspaceID = workspaceID;
+    g_pCompositor->setWindowWorkspace(PWINDOW, workspaceID);
     PWINDOW->m_iMonitorID = NEWWORKSPACE->m_iMonitorID;
     PWINDOW->m_bIsFullscreen = false;
 
@@ -304,17 +355,22 @@ void CKeybindManager::moveActiveToWorkspace(std::string args) {
         PWINDOW->m_vEffectivePosition = PWINDOW->m_vRealPosition;
         PWINDOW->m_vPosition = PWINDOW->m_vRealPosition;
     }
+
+    g_pCompositor->windowGeometryChanged(PWINDOW);
+
+    // the window's old workspace might be empty and hidden now
+    g_pCompositor->sanityCheckWorkspaces();
 }
 
-void CKeybindManager::moveFocusTo(std::string args) {
-    char arg = args[0];
+void CKeybindManager::moveFocusTo(const SDispatcherArg& args) {
+    const char arg = args.raw.empty() ? 0 : args.raw[0];
 
     if (arg != 'l' && arg != 'r' && arg != 'u' && arg != 'd' && arg != 't' && arg != 'b') {
-        Debug::log(ERR, "Cannot move window in direction %c, unsupported direction. Supported: l,r,u/t,d/b", arg);
+        DEBUGLOG(ERR, "Cannot move window in direction %c, unsupported direction. Supported: l,r,u/t,d/b", arg);
         return;
     }
 
-    const auto PLASTWINDOW = g_pCompositor->m_pLastWindow;
+    const auto PLASTWINDOW = g_pCompositor->m_pLastWindow.get();
 
     auto switchToWindow = [&](CWindow* PWINDOWTOCHANGETO) {
         g_pCompositor->focusWindow(PWINDOWTOCHANGETO);
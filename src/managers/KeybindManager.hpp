@@ -3,23 +3,51 @@
 #include "../defines.hpp"
 #include <deque>
 #include "../Compositor.hpp"
+#include <functional>
 
 struct SKeybind {
     std::string       key = 0;
     uint32_t          modmask = 0;
     std::string       handler = "";
     std::string       arg = "";
+
+    bool operator==(const SKeybind&) const = default;
+};
+
+// A dispatcher's arg, parsed once when the bind is resolved instead of on every press
+struct SDispatcherArg {
+    std::string       raw = "";
+    int               number = 0;        // raw as a number (with its sign), if it is one
+    bool              isNumber = false;
+    bool              relative = false;  // starts with + or -
+};
+
+// A bind with its key and handler already looked up, what actually runs on a key press
+struct SResolvedKeybind {
+    std::function<void(const SDispatcherArg&)>* pDispatcher = nullptr;
+    SDispatcherArg    arg;
 };
 
 class CKeybindManager {
 public:
+    CKeybindManager();
+
     bool                handleKeybinds(const uint32_t&, const xkb_keysym_t&);
     void                addKeybind(SKeybind);
     uint32_t            stringToModMask(std::string);
     void                clearKeybinds();
+    bool                commitKeybinds();
+    bool                invokeDispatcher(const std::string&, const std::string&);
 
 private:
     std::deque<SKeybind> m_dKeybinds;
+    std::deque<SKeybind> m_dStagedKeybinds; // filled by the config parser, swapped in by commitKeybinds
+
+    // (modmask << 32 | keysym) -> binds, rebuilt from m_dKeybinds on commit
+    std::unordered_map<uint64_t, std::vector<SResolvedKeybind>> m_mKeybindLookup;
+    std::unordered_map<std::string, std::function<void(const SDispatcherArg&)>> m_mDispatchers;
+
+    void                rebuildKeybindLookup();
 
     bool                handleInternalKeybinds(xkb_keysym_t);
 
@@ -28,10 +56,10 @@ private:
     void                spawn(std::string);
     void                toggleActiveFloating(std::string);
     void                toggleActivePseudo(std::string);
-    void                changeworkspace(std::string);
+    void                changeworkspace(const SDispatcherArg&);
     void                fullscreenActive(std::string);
-    void                moveActiveToWorkspace(std::string);
-    void                moveFocusTo(std::string);
+    void                moveActiveToWorkspace(const SDispatcherArg&);
+    void                moveFocusTo(const SDispatcherArg&);
     void                toggleGroup(std::string);
     void                changeGroupActive(std::string);
 };
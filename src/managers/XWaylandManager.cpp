@@ -6,7 +6,7 @@ CHyprXWaylandManager::CHyprXWaylandManager() {
     m_sWLRXWayland = wlr_xwayland_create(g_pCompositor->m_sWLDisplay, g_pCompositor->m_sWLRCompositor, 1);
 
     if (!m_sWLRXWayland) {
-        Debug::log(ERR, "Couldn't start up the XWaylandManager because wlr_xwayland_create returned a nullptr!");
+        DEBUGLOG(ERR, "Couldn't start up the XWaylandManager because wlr_xwayland_create returned a nullptr!");
         return;
     }
 
@@ -15,7 +15,7 @@ CHyprXWaylandManager::CHyprXWaylandManager() {
 
     setenv("DISPLAY", m_sWLRXWayland->display_name, 1);
 
-    Debug::log(LOG, "CHyprXWaylandManager started on display %s", m_sWLRXWayland->display_name);
+    DEBUGLOG(LOG, "CHyprXWaylandManager started on display %s", m_sWLRXWayland->display_name);
 }
 
 CHyprXWaylandManager::~CHyprXWaylandManager() {
@@ -79,7 +79,7 @@ std::string CHyprXWaylandManager::getTitle(CWindow* pWindow) {
             return "";
         }
     } catch (...) {
-        Debug::log(ERR, "Error in getTitle (probably null title)");
+        DEBUGLOG(ERR, "Error in getTitle (probably null title)");
     }
 
     return "";
@@ -99,7 +99,7 @@ std::string CHyprXWaylandManager::getAppIDClass(CWindow* pWindow) {
             return "";
         }
     } catch (std::logic_error& e) {
-        Debug::log(ERR, "Error in getAppIDClass: %s", e.what());
+        DEBUGLOG(ERR, "Error in getAppIDClass: %s", e.what());
     }
 
     return "";
@@ -46,7 +46,7 @@ bool CFramebuffer::alloc(int w, int h) {
         auto status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
         RASSERT((status == GL_FRAMEBUFFER_COMPLETE), "Framebuffer incomplete, couldn't create! (FB status: %i)", status);
 
-        Debug::log(LOG, "Framebuffer created, status %i", status);
+        DEBUGLOG(LOG, "Framebuffer created, status %i", status);
     }
 
     glBindTexture(GL_TEXTURE_2D, 0);
@@ -1,6 +1,9 @@
 #include "OpenGL.hpp"
 #include "../Compositor.hpp"
 #include "../helpers/MiscFunctions.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 
 CHyprOpenGLImpl::CHyprOpenGLImpl() {
     RASSERT(eglMakeCurrent(g_pCompositor->m_sWLREGL->display, EGL_NO_SURFACE, EGL_NO_SURFACE, g_pCompositor->m_sWLREGL->context), "Couldn't make the EGL current!");
@@ -13,16 +16,20 @@ CHyprOpenGLImpl::CHyprOpenGLImpl() {
 
     m_szExtensions = EXTENSIONS;
 
-    Debug::log(LOG, "Creating the Hypr OpenGL Renderer!");
-    Debug::log(LOG, "Using: %s", glGetString(GL_VERSION));
-    Debug::log(LOG, "Vendor: %s", glGetString(GL_VENDOR));
-    Debug::log(LOG, "Renderer: %s", glGetString(GL_RENDERER));
-    Debug::log(LOG, "Supported extensions size: %d", std::count(m_szExtensions.begin(), m_szExtensions.end(), ' '));
+    DEBUGLOG(LOG, "Creating the Hypr OpenGL Renderer!");
+    DEBUGLOG(LOG, "Using: %s", glGetString(GL_VERSION));
+    DEBUGLOG(LOG, "Vendor: %s", glGetString(GL_VENDOR));
+    DEBUGLOG(LOG, "Renderer: %s", glGetString(GL_RENDERER));
+    DEBUGLOG(LOG, "Supported extensions size: %d", std::count(m_szExtensions.begin(), m_szExtensions.end(), ' '));
 
     #ifdef GLES2
-    Debug::log(WARN, "!RENDERER: Using the legacy GLES2 renderer!");
+    DEBUGLOG(WARN, "!RENDERER: Using the legacy GLES2 renderer!");
     #endif
 
+    const auto SHADERSBEGIN = std::chrono::steady_clock::now();
+
+    initShaderCache();
+
     // Init shaders
 
     GLuint prog = createProgram(QUADVERTSRC, QUADFRAGSRC);
@@ -31,50 +38,46 @@ CHyprOpenGLImpl::CHyprOpenGLImpl() {
     m_shQUAD.color = glGetUniformLocation(prog, "color");
     m_shQUAD.posAttrib = glGetAttribLocation(prog, "pos");
 
-    prog = createProgram(TEXVERTSRC, TEXFRAGSRCRGBA);
-    m_shRGBA.program = prog;
-    m_shRGBA.proj = glGetUniformLocation(prog, "proj");
-    m_shRGBA.tex = glGetUniformLocation(prog, "tex");
-    m_shRGBA.alpha = glGetUniformLocation(prog, "alpha");
-    m_shRGBA.texAttrib = glGetAttribLocation(prog, "texcoord");
-    m_shRGBA.posAttrib = glGetAttribLocation(prog, "pos");
-    m_shRGBA.discardOpaque = glGetUniformLocation(prog, "discardOpaque");
-
-    prog = createProgram(TEXVERTSRC, TEXFRAGSRCRGBX);
-    m_shRGBX.program = prog;
-    m_shRGBX.tex = glGetUniformLocation(prog, "tex");
-    m_shRGBX.proj = glGetUniformLocation(prog, "proj");
-    m_shRGBX.alpha = glGetUniformLocation(prog, "alpha");
-    m_shRGBX.texAttrib = glGetAttribLocation(prog, "texcoord");
-    m_shRGBX.posAttrib = glGetAttribLocation(prog, "pos");
-    m_shRGBX.discardOpaque = glGetUniformLocation(prog, "discardOpaque");
-
-    prog = createProgram(TEXVERTSRC, TEXFRAGSRCEXT);
-    m_shEXT.program = prog;
-    m_shEXT.tex = glGetUniformLocation(prog, "tex");
-    m_shEXT.proj = glGetUniformLocation(prog, "proj");
-    m_shEXT.alpha = glGetUniformLocation(prog, "alpha");
-    m_shEXT.posAttrib = glGetAttribLocation(prog, "pos");
-    m_shEXT.texAttrib = glGetAttribLocation(prog, "texcoord");
-    m_shEXT.discardOpaque = glGetUniformLocation(prog, "discardOpaque");
-
-    prog = createProgram(TEXVERTSRC, FRAGBLUR1);
-    m_shBLUR1.program = prog;
-    m_shBLUR1.tex = glGetUniformLocation(prog, "tex");
-    m_shBLUR1.alpha = glGetUniformLocation(prog, "alpha");
-    m_shBLUR1.proj = glGetUniformLocation(prog, "proj");
-    m_shBLUR1.posAttrib = glGetAttribLocation(prog, "pos");
-    m_shBLUR1.texAttrib = glGetAttribLocation(prog, "texcoord");
-
-    prog = createProgram(TEXVERTSRC, FRAGBLUR2);
-    m_shBLUR2.program = prog;
-    m_shBLUR2.tex = glGetUniformLocation(prog, "tex");
-    m_shBLUR2.alpha = glGetUniformLocation(prog, "alpha");
-    m_shBLUR2.proj = glGetUniformLocation(prog, "proj");
-    m_shBLUR2.posAttrib = glGetAttribLocation(prog, "pos");
-    m_shBLUR2.texAttrib = glGetAttribLocation(prog, "texcoord");
-
-    Debug::log(LOG, "Shaders initialized successfully.");
+    initShader(&m_shBLUR1, createProgram(TEXVERTSRC, FRAGBLUR1));
+    initShader(&m_shBLUR2, createProgram(TEXVERTSRC, FRAGBLUR2));
+    initShader(&m_shBLURDOWN, createProgram(TEXVERTSRC, FRAGBLURDOWN));
+    initShader(&m_shBLURUP, createProgram(TEXVERTSRC, FRAGBLURUP));
+
+    DEBUGLOG(LOG, "Shaders initialized successfully.");
+
+    // Upload the unit quad once, every textured / solid quad is drawn from it with a different matrix
+    glGenBuffers(1, &m_iQuadVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_iQuadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(fullVerts), fullVerts, GL_STATIC_DRAW);
+
+    // the border is a line strip of 41 verts, re-uploaded in place when drawn
+    glGenBuffers(1, &m_iBorderVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_iBorderVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 41 * 2, nullptr, GL_DYNAMIC_DRAW);
+
+    // the damaged parts of a quad, see drawQuadWithDamage
+    glGenBuffers(1, &m_iDamageVBO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    createVAO(&m_shQUAD.vao, m_iQuadVBO, m_shQUAD.posAttrib);
+    createVAO(&m_shQUAD.damageVao, m_iDamageVBO, m_shQUAD.posAttrib);
+    createVAO(&m_iBorderVAO, m_iBorderVBO, m_shQUAD.posAttrib);
+    for (auto& s : {&m_shBLUR1, &m_shBLUR2, &m_shBLURDOWN, &m_shBLURUP}) {
+        createVAO(&s->vao, m_iQuadVBO, s->posAttrib, s->texAttrib);
+        createVAO(&s->damageVao, m_iDamageVBO, s->posAttrib, s->texAttrib);
+    }
+
+    DEBUGLOG(LOG, "Vertex buffers initialized successfully.");
+
+    // every variant a draw can ask for, so that none gets compiled mid-frame. Most come from the program cache.
+    for (auto& type : {TEXTURE_RGBA, TEXTURE_RGBX, TEXTURE_EXTERNAL}) {
+        for (uint8_t features = 0; features <= SH_FEAT_ALL; ++features)
+            getTexShader(type, features);
+    }
+
+    const auto SHADERSMS = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - SHADERSBEGIN).count();
+    DEBUGLOG(LOG, "Startup: shaders ready in %.2fms (%i programs from the cache, %i compiled)", SHADERSMS, m_iProgramsFromCache, m_iProgramsCompiled);
 
     // End shaders
 
@@ -83,7 +86,158 @@ CHyprOpenGLImpl::CHyprOpenGLImpl() {
     // Done!
 }
 
+// FNV-1a, the cache keys have to stay the same between runs
+uint64_t hashString(const std::string& str) {
+    uint64_t hash = 14695981039346656037ull;
+
+    for (const auto& c : str) {
+        hash ^= (uint8_t)c;
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+void CHyprOpenGLImpl::initShaderCache() {
+    GLint formats = 0;
+
+#ifdef GLES2
+    if (m_szExtensions.find("GL_OES_get_program_binary") == std::string::npos) {
+        DEBUGLOG(LOG, "Shader cache: GL_OES_get_program_binary not supported, compiling every time");
+        return;
+    }
+
+    m_pGetProgramBinary = (PFNGLGETPROGRAMBINARYOESPROC)eglGetProcAddress("glGetProgramBinaryOES");
+    m_pProgramBinary = (PFNGLPROGRAMBINARYOESPROC)eglGetProcAddress("glProgramBinaryOES");
+
+    if (!m_pGetProgramBinary || !m_pProgramBinary)
+        return;
+
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &formats);
+#else
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+#endif
+
+    if (formats < 1) {
+        DEBUGLOG(LOG, "Shader cache: the driver has no program binary formats, compiling every time");
+        return;
+    }
+
+    const char* const ENVCACHE = getenv("XDG_CACHE_HOME");
+    const char* const ENVHOME = getenv("HOME");
+
+    std::string base = "";
+    if (ENVCACHE && ENVCACHE[0] != '\0')
+        base = std::string(ENVCACHE) + "/hyprland/shaders";
+    else if (ENVHOME)
+        base = std::string(ENVHOME) + "/.cache/hyprland/shaders";
+    else
+        return;
+
+    // a binary is only good for the exact driver that made it
+    const std::string DRIVER = std::string((const char*)glGetString(GL_VENDOR)) + "|" + (const char*)glGetString(GL_RENDERER) + "|" + (const char*)glGetString(GL_VERSION);
+    const std::string DIR = base + "/" + getFormat("%016llx", (unsigned long long)hashString(DRIVER));
+
+    std::error_code ec;
+    std::filesystem::create_directories(DIR, ec);
+
+    if (ec) {
+        DEBUGLOG(WARN, "Shader cache: couldn't create %s: %s", DIR.c_str(), ec.message().c_str());
+        return;
+    }
+
+    m_szShaderCacheDir = DIR;
+
+    DEBUGLOG(LOG, "Shader cache: using %s", DIR.c_str());
+}
+
+GLuint CHyprOpenGLImpl::loadCachedProgram(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file.good())
+        return 0;
+
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() <= sizeof(uint32_t))
+        return 0;
+
+    uint32_t format = 0;
+    memcpy(&format, data.data(), sizeof(uint32_t));
+
+    const auto PROG = glCreateProgram();
+
+#ifdef GLES2
+    m_pProgramBinary(PROG, format, data.data() + sizeof(uint32_t), data.size() - sizeof(uint32_t));
+#else
+    glProgramBinary(PROG, format, data.data() + sizeof(uint32_t), data.size() - sizeof(uint32_t));
+#endif
+
+    GLint ok;
+    glGetProgramiv(PROG, GL_LINK_STATUS, &ok);
+
+    if (ok == GL_FALSE) {
+        // driver changed under the same version string or the file is broken, it gets rebuilt
+        DEBUGLOG(WARN, "Shader cache: rejected %s, recompiling", path.c_str());
+        glDeleteProgram(PROG);
+        std::filesystem::remove(path);
+        return 0;
+    }
+
+    return PROG;
+}
+
+void CHyprOpenGLImpl::saveCachedProgram(GLuint prog, const std::string& path) {
+    GLint length = 0;
+#ifdef GLES2
+    glGetProgramiv(prog, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+#else
+    glGetProgramiv(prog, GL_PROGRAM_BINARY_LENGTH, &length);
+#endif
+
+    if (length <= 0)
+        return;
+
+    std::vector<char> data(sizeof(uint32_t) + length);
+    GLenum format = 0;
+
+#ifdef GLES2
+    m_pGetProgramBinary(prog, length, nullptr, &format, data.data() + sizeof(uint32_t));
+#else
+    glGetProgramBinary(prog, length, nullptr, &format, data.data() + sizeof(uint32_t));
+#endif
+
+    const uint32_t FORMAT = format;
+    memcpy(data.data(), &FORMAT, sizeof(uint32_t));
+
+    // written aside and moved in place, so a crash never leaves half a binary behind
+    const std::string TEMPPATH = path + ".tmp";
+
+    std::ofstream file(TEMPPATH, std::ios::binary | std::ios::trunc);
+    file.write(data.data(), data.size());
+    file.close();
+
+    if (!file.good()) {
+        std::filesystem::remove(TEMPPATH);
+        return;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(TEMPPATH, path, ec);
+}
+
 GLuint CHyprOpenGLImpl::createProgram(const std::string& vert, const std::string& frag) {
+    const std::string CACHEPATH = m_szShaderCacheDir.empty() ? "" : m_szShaderCacheDir + "/" + getFormat("%016llx", (unsigned long long)hashString(vert + '\0' + frag));
+
+    if (!CACHEPATH.empty()) {
+        const auto PROG = loadCachedProgram(CACHEPATH);
+
+        if (PROG) {
+            m_iProgramsFromCache++;
+            return PROG;
+        }
+    }
+
     auto vertCompiled = compileShader(GL_VERTEX_SHADER, vert);
     RASSERT(vertCompiled, "Compiling shader failed. VERTEX NULL! Shader source:\n\n%s", vert.c_str());
 
@@ -93,6 +247,10 @@ GLuint CHyprOpenGLImpl::createProgram(const std::string& vert, const std::string
     auto prog = glCreateProgram();
     glAttachShader(prog, vertCompiled);
     glAttachShader(prog, fragCompiled);
+#ifndef GLES2
+    if (!CACHEPATH.empty())
+        glProgramParameteri(prog, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
     glLinkProgram(prog);
 
     glDetachShader(prog, vertCompiled);
@@ -104,9 +262,65 @@ GLuint CHyprOpenGLImpl::createProgram(const std::string& vert, const std::string
     glGetProgramiv(prog, GL_LINK_STATUS, &ok);
     RASSERT(ok != GL_FALSE, "createProgram() failed! GL_LINK_STATUS not OK!");
 
+    m_iProgramsCompiled++;
+
+    if (!CACHEPATH.empty())
+        saveCachedProgram(prog, CACHEPATH);
+
     return prog;
 }
 
+std::string getTexFragSource(TEXTURETYPE type, uint8_t features) {
+    std::string defines = "";
+
+    if (type == TEXTURE_EXTERNAL)
+        defines += "#define EXTERNAL\n";
+    else if (type == TEXTURE_RGBX)
+        defines += "#define RGBX\n";
+
+    if (features & SH_FEAT_ROUNDING)
+        defines += "#define ROUNDING\n";
+    if (features & SH_FEAT_DISCARDOPAQUE)
+        defines += "#define DISCARDOPAQUE\n";
+    if (features & SH_FEAT_ALPHAONE)
+        defines += "#define ALPHAONE\n";
+
+    return defines + TEXFRAGSRC;
+}
+
+CShader* CHyprOpenGLImpl::getTexShader(TEXTURETYPE type, uint8_t features) {
+    const uint32_t KEY = ((uint32_t)type << 8) | features;
+
+    const auto IT = m_mTexShaders.find(KEY);
+    if (IT != m_mTexShaders.end())
+        return &IT->second;
+
+    const auto PSHADER = &m_mTexShaders[KEY];
+    initShader(PSHADER, createProgram(TEXVERTSRC, getTexFragSource(type, features)));
+    createVAO(&PSHADER->vao, m_iQuadVBO, PSHADER->posAttrib, PSHADER->texAttrib);
+    createVAO(&PSHADER->damageVao, m_iDamageVBO, PSHADER->posAttrib, PSHADER->texAttrib);
+
+    DEBUGLOG(LOG, "Compiled texture shader variant %x", KEY);
+
+    return PSHADER;
+}
+
+// Every location is looked up once here, the ones a shader doesn't have are -1 and glUniform ignores them.
+void CHyprOpenGLImpl::initShader(CShader* pShader, GLuint prog) {
+    pShader->program = prog;
+    pShader->proj = glGetUniformLocation(prog, "proj");
+    pShader->tex = glGetUniformLocation(prog, "tex");
+    pShader->alpha = glGetUniformLocation(prog, "alpha");
+    pShader->topLeft = glGetUniformLocation(prog, "topLeft");
+    pShader->bottomRight = glGetUniformLocation(prog, "bottomRight");
+    pShader->fullSize = glGetUniformLocation(prog, "fullSize");
+    pShader->radius = glGetUniformLocation(prog, "radius");
+    pShader->resolution = glGetUniformLocation(prog, "resolution");
+    pShader->halfpixel = glGetUniformLocation(prog, "halfpixel");
+    pShader->posAttrib = glGetAttribLocation(prog, "pos");
+    pShader->texAttrib = glGetAttribLocation(prog, "texcoord");
+}
+
 GLuint CHyprOpenGLImpl::compileShader(const GLuint& type, std::string src) {
     auto shader = glCreateShader(type);
 
@@ -122,8 +336,201 @@ GLuint CHyprOpenGLImpl::compileShader(const GLuint& type, std::string src) {
     return shader;
 }
 
-void CHyprOpenGLImpl::begin(SMonitor* pMonitor, pixman_region32_t* pDamage) {
+// VAOs are GLES3 only, on GLES2 the buffer and the attrib pointers are set on every bind instead.
+// Either way the verts stay on the GPU.
+void CHyprOpenGLImpl::createVAO(GLuint* vao, GLuint vbo, GLint posAttrib, GLint texAttrib) {
+#ifndef GLES2
+    glGenVertexArrays(1, vao);
+    glBindVertexArray(*vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    glEnableVertexAttribArray(posAttrib);
+
+    if (texAttrib != -1) {
+        glVertexAttribPointer(texAttrib, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+        glEnableVertexAttribArray(texAttrib);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+#endif
+}
+
+void CHyprOpenGLImpl::bindVertices(GLuint vao, GLuint vbo, GLint posAttrib, GLint texAttrib) {
+#ifndef GLES2
+    glBindVertexArray(vao);
+#else
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    glVertexAttribPointer(posAttrib, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+    glEnableVertexAttribArray(posAttrib);
+
+    if (texAttrib != -1) {
+        glVertexAttribPointer(texAttrib, 2, GL_FLOAT, GL_FALSE, 0, (void*)0);
+        glEnableVertexAttribArray(texAttrib);
+    }
+#endif
+}
+
+void CHyprOpenGLImpl::unbindVertices(GLint posAttrib, GLint texAttrib) {
+    // wlroots draws the software cursors with client-side arrays afterwards,
+    // so leave no VAO / buffer bound behind.
+#ifndef GLES2
+    glBindVertexArray(0);
+#else
+    glDisableVertexAttribArray(posAttrib);
+
+    if (texAttrib != -1)
+        glDisableVertexAttribArray(texAttrib);
+#endif
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// The state below is only changed through these, so they can tell when a call would be a no-op.
+// Anything else touching it (wlroots drawing the cursors) has to be followed by invalidateGLState().
+void CHyprOpenGLImpl::useProgram(GLuint prog) {
+    if (m_sGLState.program == prog) {
+        m_sGLStateStats.useProgram.avoided++;
+        return;
+    }
+
+    glUseProgram(prog);
+    m_sGLState.program = prog;
+    m_sGLStateStats.useProgram.issued++;
+}
+
+void CHyprOpenGLImpl::setBlend(bool enabled) {
+    if (m_sGLState.blend == (int)enabled) {
+        m_sGLStateStats.blend.avoided++;
+        return;
+    }
+
+    if (enabled)
+        glEnable(GL_BLEND);
+    else
+        glDisable(GL_BLEND);
+
+    m_sGLState.blend = enabled;
+    m_sGLStateStats.blend.issued++;
+}
+
+void CHyprOpenGLImpl::activeTexture(GLenum unit) {
+    if (m_sGLState.activeTexture == unit) {
+        m_sGLStateStats.activeTexture.avoided++;
+        return;
+    }
+
+    glActiveTexture(unit);
+    m_sGLState.activeTexture = unit;
+    m_sGLStateStats.activeTexture.issued++;
+}
+
+// expects the texture to be bound
+void CHyprOpenGLImpl::setLinearFilter(GLenum target, GLuint tex) {
+    const auto FILTEREDEND = m_sGLState.linearFiltered.begin() + m_sGLState.linearFilteredCount;
+
+    if (std::find(m_sGLState.linearFiltered.begin(), FILTEREDEND, tex) != FILTEREDEND) {
+        m_sGLStateStats.texParameter.avoided++;
+        return;
+    }
+
+    if (m_sGLState.linearFilteredCount < m_sGLState.linearFiltered.size())
+        m_sGLState.linearFiltered[m_sGLState.linearFilteredCount++] = tex;
+
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    m_sGLStateStats.texParameter.issued++;
+}
+
+void CHyprOpenGLImpl::invalidateGLState() {
+    // texture ids get reused after the clients' buffers are released, so the filters are forgotten too
+    m_sGLState = SGLState();
+}
+
+// Draws the unit quad, as placed by glMatrix (transposed, as uploaded), only inside the damage.
+// Every rect is mapped back into the quad's own 0-1 coords and clipped to it there, so pos and texcoord
+// stay what they'd be for the whole quad. All of them go out in one upload and one draw, no scissoring.
+void CHyprOpenGLImpl::drawQuadWithDamage(const float* glMatrix, pixman_region32_t* pDamage, GLuint vao, GLuint damageVao, GLint posAttrib, GLint texAttrib) {
+    // no damage means the caller already set up the scissor
+    if (!pDamage) {
+        bindVertices(vao, m_iQuadVBO, posAttrib, texAttrib);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        unbindVertices(posAttrib, texAttrib);
+        return;
+    }
+
+    if (!pixman_region32_not_empty(pDamage))
+        return;
+
+    // ndc = (M0 * u + M3 * v + M6, M1 * u + M4 * v + M7), outputs only rotate by 90s so this stays axis aligned
+    const auto M = glMatrix;
+    const float DET = M[0] * M[4] - M[3] * M[1];
+
+    if (DET == 0.f)
+        return;
+
+    const auto VIEWPORT = m_RenderData.pMonitor->vecSize;  // what glViewport is always set to
+    const auto toQuad = [&](float x, float y) {
+        const float NX = x / VIEWPORT.x * 2.f - 1.f - M[6];
+        const float NY = y / VIEWPORT.y * 2.f - 1.f - M[7];
+        return Vector2D((M[4] * NX - M[3] * NY) / DET, (M[0] * NY - M[1] * NX) / DET);
+    };
+
+    m_vDamageVerts.clear();
+
+    PIXMAN_DAMAGE_FOREACH(pDamage) {
+        const auto RECT = RECTSARR[i];
+        const auto A = toQuad(RECT.x1, RECT.y1);
+        const auto B = toQuad(RECT.x2, RECT.y2);
+
+        const float U1 = std::clamp(std::min(A.x, B.x), 0.0, 1.0);
+        const float U2 = std::clamp(std::max(A.x, B.x), 0.0, 1.0);
+        const float V1 = std::clamp(std::min(A.y, B.y), 0.0, 1.0);
+        const float V2 = std::clamp(std::max(A.y, B.y), 0.0, 1.0);
+
+        if (U1 >= U2 || V1 >= V2)
+            continue;  // doesn't touch the quad
+
+        m_vDamageVerts.insert(m_vDamageVerts.end(), {U1, V1, U2, V1, U1, V2, U2, V1, U2, V2, U1, V2});
+    }
+
+    if (m_vDamageVerts.empty())
+        return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_iDamageVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * m_vDamageVerts.size(), m_vDamageVerts.data(), GL_STREAM_DRAW);
+
+    bindVertices(damageVao, m_iDamageVBO, posAttrib, texAttrib);
+
+    glDrawArrays(GL_TRIANGLES, 0, m_vDamageVerts.size() / 2);
+
+    unbindVertices(posAttrib, texAttrib);
+}
+
+// for what isn't a quad (the border), one scissored draw per damage rect
+void CHyprOpenGLImpl::drawArraysWithDamage(GLenum mode, GLsizei count, pixman_region32_t* pDamage) {
+    // no damage means the caller already set up the scissor
+    if (!pDamage) {
+        glDrawArrays(mode, 0, count);
+        return;
+    }
+
+    // the state is set up once, only the scissor changes per rect
+    if (pixman_region32_not_empty(pDamage)) {
+        PIXMAN_DAMAGE_FOREACH(pDamage) {
+            const auto RECT = RECTSARR[i];
+            scissor(&RECT);
+
+            glDrawArrays(mode, 0, count);
+        }
+    }
+
+    scissor((wlr_box*)nullptr);
+}
+
+void CHyprOpenGLImpl::begin(SMonitor* pMonitor, pixman_region32_t* pDamage, bool directToOutput) {
     m_RenderData.pMonitor = pMonitor;
+    m_RenderData.directToOutput = directToOutput;
 
     glViewport(0, 0, pMonitor->vecSize.x, pMonitor->vecSize.y);
 
@@ -143,12 +550,19 @@ void CHyprOpenGLImpl::begin(SMonitor* pMonitor, pixman_region32_t* pDamage) {
 
         m_mMonitorRenderResources[pMonitor].primaryFB.alloc(pMonitor->vecSize.x * pMonitor->scale, pMonitor->vecSize.y * pMonitor->scale);
         m_mMonitorRenderResources[pMonitor].mirrorFB.alloc(pMonitor->vecSize.x * pMonitor->scale, pMonitor->vecSize.y * pMonitor->scale);
+        m_mMonitorRenderResources[pMonitor].mirrorSwapFB.alloc(pMonitor->vecSize.x * pMonitor->scale, pMonitor->vecSize.y * pMonitor->scale);
+        m_mMonitorRenderResources[pMonitor].blurFB.alloc(pMonitor->vecSize.x * pMonitor->scale, pMonitor->vecSize.y * pMonitor->scale);
+        m_mMonitorRenderResources[pMonitor].blurFBDirty = true;
 
         createBGTextureForMonitor(pMonitor);
     }
 
+    // wlroots used the context since our last frame
+    invalidateGLState();
+
     // bind the primary Hypr Framebuffer
-    m_mMonitorRenderResources[pMonitor].primaryFB.bind();
+    if (!directToOutput)
+        m_mMonitorRenderResources[pMonitor].primaryFB.bind();
 
     m_RenderData.pDamage = pDamage;
 
@@ -157,17 +571,42 @@ void CHyprOpenGLImpl::begin(SMonitor* pMonitor, pixman_region32_t* pDamage) {
 }
 
 void CHyprOpenGLImpl::end() {
-    // end the render, copy the data to the WLR framebuffer
-    glBindFramebuffer(GL_FRAMEBUFFER, m_iWLROutputFb);
-    wlr_box windowBox = {0, 0, m_RenderData.pMonitor->vecSize.x, m_RenderData.pMonitor->vecSize.y};
+    // the software cursors were drawn by wlroots in between
+    invalidateGLState();
 
-    clear(CColor(11, 11, 11, 255));
+    // end the render, copy the damaged parts to the WLR framebuffer
+    if (!m_RenderData.directToOutput) {
+#ifndef GLES2
+        // primaryFB is opaque and laid out like the output, so a plain blit does it
+        const auto PRIMARYFB = &m_mMonitorRenderResources[m_RenderData.pMonitor].primaryFB;
+
+        scissor((wlr_box*)nullptr);
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, PRIMARYFB->m_iFb);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_iWLROutputFb);
+
+        if (pixman_region32_not_empty(m_RenderData.pDamage)) {
+            PIXMAN_DAMAGE_FOREACH(m_RenderData.pDamage) {
+                const auto RECT = RECTSARR[i];
+                glBlitFramebuffer(RECT.x1, RECT.y1, RECT.x2, RECT.y2, RECT.x1, RECT.y1, RECT.x2, RECT.y2, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            }
+        }
 
-    scaleBox(&windowBox, m_RenderData.pMonitor->scale);
-    renderTexture(m_mMonitorRenderResources[m_RenderData.pMonitor].primaryFB.m_cTex, &windowBox, 255.f, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_iWLROutputFb);
+#else
+        glBindFramebuffer(GL_FRAMEBUFFER, m_iWLROutputFb);
+        wlr_box windowBox = {0, 0, m_RenderData.pMonitor->vecSize.x, m_RenderData.pMonitor->vecSize.y};
+
+        clear(CColor(11, 11, 11, 255));
+
+        scaleBox(&windowBox, m_RenderData.pMonitor->scale);
+        renderTexture(m_mMonitorRenderResources[m_RenderData.pMonitor].primaryFB.m_cTex, &windowBox, 255.f, 0);
+#endif
+    }
 
     // reset our data
     m_RenderData.pMonitor = nullptr;
+    m_RenderData.directToOutput = false;
     m_iWLROutputFb = 0;
 }
 
@@ -216,8 +655,6 @@ void CHyprOpenGLImpl::renderRect(wlr_box* box, const CColor& col) {
     RASSERT((box->width > 0 && box->height > 0), "Tried to render rect with width/height < 0!");
     RASSERT(m_RenderData.pMonitor, "Tried to render rect without begin()!");
 
-    // TODO: respect damage
-
     float matrix[9];
     wlr_matrix_project_box(matrix, box, WL_OUTPUT_TRANSFORM_NORMAL, 0, m_RenderData.pMonitor->output->transform_matrix);  // TODO: write own, don't use WLR here
 
@@ -227,23 +664,14 @@ void CHyprOpenGLImpl::renderRect(wlr_box* box, const CColor& col) {
 
     wlr_matrix_transpose(glMatrix, glMatrix);
 
-    if (col.a == 255.f) 
-        glDisable(GL_BLEND);
-    else
-        glEnable(GL_BLEND);
+    setBlend(col.a != 255.f);
 
-    glUseProgram(m_shQUAD.program);
+    useProgram(m_shQUAD.program);
 
     glUniformMatrix3fv(m_shQUAD.proj, 1, GL_FALSE, glMatrix);
     glUniform4f(m_shQUAD.color, col.r / 255.f, col.g / 255.f, col.b / 255.f, col.a / 255.f);
 
-    glVertexAttribPointer(m_shQUAD.posAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-
-    glEnableVertexAttribArray(m_shQUAD.posAttrib);
-
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-    glDisableVertexAttribArray(m_shQUAD.posAttrib);
+    drawQuadWithDamage(glMatrix, m_RenderData.pDamage, m_shQUAD.vao, m_shQUAD.damageVao, m_shQUAD.posAttrib);
 }
 
 void CHyprOpenGLImpl::renderTexture(wlr_texture* tex, wlr_box* pBox, float alpha, int round) {
@@ -255,20 +683,14 @@ void CHyprOpenGLImpl::renderTexture(wlr_texture* tex, wlr_box* pBox, float alpha
 void CHyprOpenGLImpl::renderTexture(const CTexture& tex, wlr_box* pBox, float alpha, int round) {
     RASSERT(m_RenderData.pMonitor, "Tried to render texture without begin()!");
 
-    // TODO: optimize this, this is bad
-    if (pixman_region32_not_empty(m_RenderData.pDamage)) {
-        PIXMAN_DAMAGE_FOREACH(m_RenderData.pDamage) {
-            const auto RECT = RECTSARR[i];
-            scissor(&RECT);
-
-            renderTextureInternal(tex, pBox, alpha, round);
-        }
-    }
-
-    scissor((wlr_box*)nullptr);
+    renderTextureInternalWithDamage(tex, pBox, alpha, m_RenderData.pDamage, round);
 }
 
 void CHyprOpenGLImpl::renderTextureInternal(const CTexture& tex, wlr_box* pBox, float alpha, int round, bool discardOpaque) {
+    renderTextureInternalWithDamage(tex, pBox, alpha, nullptr, round, discardOpaque);
+}
+
+void CHyprOpenGLImpl::renderTextureInternalWithDamage(const CTexture& tex, wlr_box* pBox, float alpha, pixman_region32_t* pDamage, int round, bool discardOpaque) {
     RASSERT(m_RenderData.pMonitor, "Tried to render texture without begin()!");
     RASSERT((tex.m_iTexID > 0), "Attempted to draw NULL texture!");
 
@@ -283,66 +705,110 @@ void CHyprOpenGLImpl::renderTextureInternal(const CTexture& tex, wlr_box* pBox,
 
     wlr_matrix_transpose(glMatrix, glMatrix);
 
-    CShader* shader = nullptr;
-
-    glEnable(GL_BLEND);
+    RASSERT(tex.m_iType != TEXTURE_INVALID, "tex.m_iType unsupported!");
 
-    switch (tex.m_iType) {
-        case TEXTURE_RGBA:
-            shader = &m_shRGBA;
-            break;
-        case TEXTURE_RGBX:
-            shader = &m_shRGBX;
-            break;
-        case TEXTURE_EXTERNAL:
-            shader = &m_shEXT;
-            break;
-        default:
-            RASSERT(false, "tex.m_iTarget unsupported!");
-    }
+    // nothing to blend with an opaque texture, the discards still work without it
+    setBlend(!(tex.m_iType == TEXTURE_RGBX && alpha == 255.f));
 
-    glActiveTexture(GL_TEXTURE0);
+    activeTexture(GL_TEXTURE0);
     glBindTexture(tex.m_iTarget, tex.m_iTexID);
 
-    glTexParameteri(tex.m_iTarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    setLinearFilter(tex.m_iTarget, tex.m_iTexID);
 
-    glUseProgram(shader->program);
+    uint8_t features = 0;
+    if (discardOpaque)
+        features |= SH_FEAT_DISCARDOPAQUE;
+    if (alpha == 255.f)
+        features |= SH_FEAT_ALPHAONE;
 
-    glUniformMatrix3fv(shader->proj, 1, GL_FALSE, glMatrix);
-    glUniform1i(shader->tex, 0);
-    glUniform1f(shader->alpha, alpha / 255.f);
-    glUniform1i(shader->discardOpaque, (int)discardOpaque);
+    auto drawWithShader = [&](CShader* pShader, pixman_region32_t* pDrawDamage) {
+        if (pDrawDamage && !pixman_region32_not_empty(pDrawDamage))
+            return;
 
-    // round is in px
-    // so we need to do some maf
+        useProgram(pShader->program);
 
-    const auto TOPLEFT = Vector2D(round, round);
-    const auto BOTTOMRIGHT = Vector2D(tex.m_vSize.x - round, tex.m_vSize.y - round);
-    const auto FULLSIZE = tex.m_vSize;
+        glUniformMatrix3fv(pShader->proj, 1, GL_FALSE, glMatrix);
+        glUniform1i(pShader->tex, 0);
+        glUniform1f(pShader->alpha, alpha / 255.f);
 
-    // Rounded corners
-    glUniform2f(glGetUniformLocation(shader->program, "topLeft"), (float)TOPLEFT.x, (float)TOPLEFT.y);
-    glUniform2f(glGetUniformLocation(shader->program, "bottomRight"), (float)BOTTOMRIGHT.x, (float)BOTTOMRIGHT.y);
-    glUniform2f(glGetUniformLocation(shader->program, "fullSize"), (float)FULLSIZE.x, (float)FULLSIZE.y);
-    glUniform1f(glGetUniformLocation(shader->program, "radius"), round);
+        // round is in px
+        // so we need to do some maf
 
-    glVertexAttribPointer(shader->posAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-    glVertexAttribPointer(shader->texAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
+        const auto TOPLEFT = Vector2D(round, round);
+        const auto BOTTOMRIGHT = Vector2D(tex.m_vSize.x - round, tex.m_vSize.y - round);
+        const auto FULLSIZE = tex.m_vSize;
 
-    glEnableVertexAttribArray(shader->posAttrib);
-    glEnableVertexAttribArray(shader->texAttrib);
+        // Rounded corners
+        glUniform2f(pShader->topLeft, (float)TOPLEFT.x, (float)TOPLEFT.y);
+        glUniform2f(pShader->bottomRight, (float)BOTTOMRIGHT.x, (float)BOTTOMRIGHT.y);
+        glUniform2f(pShader->fullSize, (float)FULLSIZE.x, (float)FULLSIZE.y);
+        glUniform1f(pShader->radius, round);
 
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        drawQuadWithDamage(glMatrix, pDrawDamage, pShader->vao, pShader->damageVao, pShader->posAttrib, pShader->texAttrib);
+    };
 
-    glDisableVertexAttribArray(shader->posAttrib);
-    glDisableVertexAttribArray(shader->texAttrib);
+    if (round > 0 && pDamage && tex.m_vSize.x > 0 && tex.m_vSize.y > 0) {
+        // only the corners need the rounding, the rest of the texture gets the variant without it
+        const int CORNERW = std::ceil(round * pBox->width / tex.m_vSize.x);
+        const int CORNERH = std::ceil(round * pBox->height / tex.m_vSize.y);
+
+        pixman_region32_t corners;
+        pixman_region32_init_rect(&corners, pBox->x, pBox->y, CORNERW, CORNERH);
+        pixman_region32_union_rect(&corners, &corners, pBox->x + pBox->width - CORNERW, pBox->y, CORNERW, CORNERH);
+        pixman_region32_union_rect(&corners, &corners, pBox->x, pBox->y + pBox->height - CORNERH, CORNERW, CORNERH);
+        pixman_region32_union_rect(&corners, &corners, pBox->x + pBox->width - CORNERW, pBox->y + pBox->height - CORNERH, CORNERW, CORNERH);
+
+        pixman_region32_t cornerDamage, interiorDamage;
+        pixman_region32_init(&cornerDamage);
+        pixman_region32_init(&interiorDamage);
+        pixman_region32_intersect(&cornerDamage, pDamage, &corners);
+        pixman_region32_subtract(&interiorDamage, pDamage, &corners);
+
+        drawWithShader(getTexShader(tex.m_iType, features), &interiorDamage);
+        drawWithShader(getTexShader(tex.m_iType, features | SH_FEAT_ROUNDING), &cornerDamage);
+
+        pixman_region32_fini(&cornerDamage);
+        pixman_region32_fini(&interiorDamage);
+        pixman_region32_fini(&corners);
+    } else {
+        drawWithShader(getTexShader(tex.m_iType, round > 0 ? features | SH_FEAT_ROUNDING : features), pDamage);
+    }
 
     glBindTexture(tex.m_iTarget, 0);
 }
 
-void CHyprOpenGLImpl::renderTextureWithBlur(const CTexture& tex, wlr_box* pBox, float a, int round) {
+void CHyprOpenGLImpl::renderTextureWithBlur(const CTexture& tex, wlr_box* pBox, float a, int round, bool cachedBlur) {
     RASSERT(m_RenderData.pMonitor, "Tried to render texture with blur without begin()!");
 
+    static const CConfigHandle<int64_t> BLUR("decoration:blur");
+    static const CConfigHandle<int64_t> BLURMETHOD("decoration:blur_method_internal");
+
+    // if blur disabled, just render the texture
+    if (*BLUR == 0) {
+        renderTexture(tex, pBox, a, round);
+        return;
+    }
+
+    // windows sitting right on the background can sample the cached blur,
+    // if it's not up to date we do the full blur instead
+    const auto PMONRENDERDATA = &m_mMonitorRenderResources[m_RenderData.pMonitor];
+    if (cachedBlur && !PMONRENDERDATA->blurFBDirty) {
+        pixman_region32_t damage;
+        pixman_region32_init(&damage);
+        pixman_region32_intersect_rect(&damage, m_RenderData.pDamage, pBox->x, pBox->y, pBox->width, pBox->height);
+
+        if (pixman_region32_not_empty(&damage))
+            renderTextureOverBlurredFB(tex, pBox, a, round, &PMONRENDERDATA->blurFB, &damage);
+
+        pixman_region32_fini(&damage);
+        return;
+    }
+
+    if (*BLURMETHOD == BLUR_METHOD_KAWASE) {
+        renderTextureWithKawaseBlur(tex, pBox, a, round);
+        return;
+    }
+
     // TODO: optimize this, this is bad
     if (pixman_region32_not_empty(m_RenderData.pDamage)) {
         PIXMAN_DAMAGE_FOREACH(m_RenderData.pDamage) {
@@ -365,20 +831,16 @@ void CHyprOpenGLImpl::renderTextureWithBlurInternal(const CTexture& tex, wlr_box
     RASSERT(m_RenderData.pMonitor, "Tried to render texture without begin()!");
     RASSERT((tex.m_iTexID > 0), "Attempted to draw NULL texture!");
 
-    // if blur disabled, just render the texture
-    if (g_pConfigManager->getInt("decoration:blur") == 0) {
-        renderTextureInternal(tex, pBox, a, round);
-        return;
-    }
-
     // get transform
     const auto TRANSFORM = wlr_output_transform_invert(WL_OUTPUT_TRANSFORM_NORMAL);
     float matrix[9];
     wlr_matrix_project_box(matrix, pBox, TRANSFORM, 0, m_RenderData.pMonitor->output->transform_matrix);
 
     // bind the mirror FB and clear it.
+    // Not with clear(), that one would drop the scissor of the rect we're in.
     m_mMonitorRenderResources[m_RenderData.pMonitor].mirrorFB.bind();
-    clear(CColor(0, 0, 0, 0));
+    glClearColor(0, 0, 0, 0);
+    glClear(GL_COLOR_BUFFER_BIT);
 
     // init stencil for blurring only behind da window
     glClearStencil(0);
@@ -400,7 +862,7 @@ void CHyprOpenGLImpl::renderTextureWithBlurInternal(const CTexture& tex, wlr_box
     // the mirror FB now has only our window.
     m_mMonitorRenderResources[m_RenderData.pMonitor].primaryFB.bind();
 
-    glEnable(GL_BLEND);
+    setBlend(true);
 
     // now we make the blur by blurring the main framebuffer (it will only affect the stencil)
 
@@ -415,34 +877,32 @@ void CHyprOpenGLImpl::renderTextureWithBlurInternal(const CTexture& tex, wlr_box
 
     wlr_matrix_transpose(glMatrix, glMatrix);
 
-    const auto RADIUS = g_pConfigManager->getInt("decoration:blur_size") + 2;
-    const auto BLURPASSES = g_pConfigManager->getInt("decoration:blur_passes");
+    static const CConfigHandle<int64_t> BLURSIZE("decoration:blur_size");
+    static const CConfigHandle<int64_t> BLURPASSESHANDLE("decoration:blur_passes");
+
+    const auto RADIUS = *BLURSIZE + 2;
+    const auto BLURPASSES = *BLURPASSESHANDLE;
     const auto PFRAMEBUFFER = &m_mMonitorRenderResources[m_RenderData.pMonitor].primaryFB;
 
     auto drawWithShader = [&](CShader* pShader) {
-        glActiveTexture(GL_TEXTURE0);
+        activeTexture(GL_TEXTURE0);
         glBindTexture(PFRAMEBUFFER->m_cTex.m_iTarget, PFRAMEBUFFER->m_cTex.m_iTexID);
 
-        glTexParameteri(tex.m_iTarget, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        setLinearFilter(PFRAMEBUFFER->m_cTex.m_iTarget, PFRAMEBUFFER->m_cTex.m_iTexID);
 
-        glUseProgram(pShader->program);
+        useProgram(pShader->program);
 
-        glUniform1f(glGetUniformLocation(pShader->program, "radius"), RADIUS);
-        glUniform2f(glGetUniformLocation(pShader->program, "resolution"), m_RenderData.pMonitor->vecSize.x, m_RenderData.pMonitor->vecSize.y);
+        glUniform1f(pShader->radius, RADIUS);
+        glUniform2f(pShader->resolution, m_RenderData.pMonitor->vecSize.x, m_RenderData.pMonitor->vecSize.y);
         glUniformMatrix3fv(pShader->proj, 1, GL_FALSE, glMatrix);
         glUniform1i(pShader->tex, 0);
         glUniform1f(pShader->alpha, a / 255.f);
 
-        glVertexAttribPointer(pShader->posAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-        glVertexAttribPointer(pShader->texAttrib, 2, GL_FLOAT, GL_FALSE, 0, fullVerts);
-
-        glEnableVertexAttribArray(pShader->posAttrib);
-        glEnableVertexAttribArray(pShader->texAttrib);
+        bindVertices(pShader->vao, m_iQuadVBO, pShader->posAttrib, pShader->texAttrib);
 
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
-        glDisableVertexAttribArray(pShader->posAttrib);
-        glDisableVertexAttribArray(pShader->texAttrib);
+        unbindVertices(pShader->posAttrib, pShader->texAttrib);
     };
 
     for (int i = 0; i < BLURPASSES; ++i) {
@@ -461,6 +921,195 @@ void CHyprOpenGLImpl::renderTextureWithBlurInternal(const CTexture& tex, wlr_box
     renderTextureInternal(tex, pBox, a, round);
 }
 
+CFramebuffer* CHyprOpenGLImpl::blurFramebufferWithDamage(CFramebuffer* pSource, pixman_region32_t* originalDamage) {
+    // get transform
+    const auto TRANSFORM = wlr_output_transform_invert(WL_OUTPUT_TRANSFORM_NORMAL);
+    float matrix[9];
+    wlr_box fullMonBox = {0, 0, m_RenderData.pMonitor->vecSize.x, m_RenderData.pMonitor->vecSize.y};
+    wlr_matrix_project_box(matrix, &fullMonBox, TRANSFORM, 0, m_RenderData.pMonitor->output->transform_matrix);
+
+    float glMatrix[9];
+    wlr_matrix_multiply(glMatrix, m_RenderData.projection, matrix);
+    wlr_matrix_multiply(glMatrix, matrixFlip180, glMatrix);
+
+    wlr_matrix_transpose(glMatrix, glMatrix);
+
+    static const CConfigHandle<int64_t> BLURSIZE("decoration:blur_size");
+    static const CConfigHandle<int64_t> BLURPASSESHANDLE("decoration:blur_passes");
+    static const CConfigHandle<int64_t> BLURMETHOD("decoration:blur_method_internal");
+
+    const auto RADIUS = *BLURSIZE;
+    const auto BLURPASSES = std::clamp(*BLURPASSESHANDLE, (int64_t)1, (int64_t)8);
+    const bool KAWASE = *BLURMETHOD == BLUR_METHOD_KAWASE;
+
+    // the blur pulls in pixels from this far outside the damage
+    pixman_region32_t damage;
+    pixman_region32_init(&damage);
+    pixman_region32_copy(&damage, originalDamage);
+    wlr_region_expand(&damage, &damage, KAWASE ? pow(2, BLURPASSES) * RADIUS : BLURPASSES * (RADIUS + 2));
+
+    const auto PMIRRORFB = &m_mMonitorRenderResources[m_RenderData.pMonitor].mirrorFB;
+    const auto PMIRRORSWAPFB = &m_mMonitorRenderResources[m_RenderData.pMonitor].mirrorSwapFB;
+
+    CFramebuffer* currentRenderToFB = pSource;
+
+    // every pass fully overwrites its area
+    setBlend(false);
+
+    auto drawPass = [&](CShader* pShader, float radius, const Vector2D& halfpixel, pixman_region32_t* pDamage) {
+        if (currentRenderToFB == PMIRRORFB)
+            PMIRRORSWAPFB->bind();
+        else
+            PMIRRORFB->bind();
+
+        activeTexture(GL_TEXTURE0);
+        glBindTexture(currentRenderToFB->m_cTex.m_iTarget, currentRenderToFB->m_cTex.m_iTexID);
+
+        setLinearFilter(currentRenderToFB->m_cTex.m_iTarget, currentRenderToFB->m_cTex.m_iTexID);
+
+        useProgram(pShader->program);
+
+        glUniformMatrix3fv(pShader->proj, 1, GL_FALSE, glMatrix);
+        glUniform1f(pShader->radius, radius);
+        glUniform2f(pShader->halfpixel, halfpixel.x, halfpixel.y);
+        glUniform2f(pShader->resolution, m_RenderData.pMonitor->vecSize.x, m_RenderData.pMonitor->vecSize.y);
+        glUniform1f(pShader->alpha, 1.f);
+        glUniform1i(pShader->tex, 0);
+
+        drawQuadWithDamage(glMatrix, pDamage, pShader->vao, pShader->damageVao, pShader->posAttrib, pShader->texAttrib);
+
+        currentRenderToFB = currentRenderToFB == PMIRRORFB ? PMIRRORSWAPFB : PMIRRORFB;
+    };
+
+    if (KAWASE) {
+        pixman_region32_t tempDamage;
+        pixman_region32_init(&tempDamage);
+
+        // down, each pass lands in the top-left 1/2^i of the FB
+        const Vector2D DOWNHALFPIXEL = Vector2D(0.5f / (m_RenderData.pMonitor->vecSize.x / 2.f), 0.5f / (m_RenderData.pMonitor->vecSize.y / 2.f));
+        for (int i = 1; i <= BLURPASSES; ++i) {
+            wlr_region_scale(&tempDamage, &damage, 1.f / (1 << i));
+            drawPass(&m_shBLURDOWN, RADIUS, DOWNHALFPIXEL, &tempDamage);
+        }
+
+        // and back up to the full size
+        const Vector2D UPHALFPIXEL = Vector2D(0.5f / (m_RenderData.pMonitor->vecSize.x * 2.f), 0.5f / (m_RenderData.pMonitor->vecSize.y * 2.f));
+        for (int i = BLURPASSES - 1; i >= 0; --i) {
+            wlr_region_scale(&tempDamage, &damage, 1.f / (1 << i));
+            drawPass(&m_shBLURUP, RADIUS, UPHALFPIXEL, &tempDamage);
+        }
+
+        pixman_region32_fini(&tempDamage);
+    } else {
+        for (int i = 0; i < BLURPASSES; ++i) {
+            drawPass(&m_shBLUR1, RADIUS + 2, Vector2D(), &damage);  // horizontal pass
+            drawPass(&m_shBLUR2, RADIUS + 2, Vector2D(), &damage);  // vertical pass
+        }
+    }
+    pixman_region32_fini(&damage);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_mMonitorRenderResources[m_RenderData.pMonitor].primaryFB.bind();
+
+    return currentRenderToFB;
+}
+
+void CHyprOpenGLImpl::renderTextureWithKawaseBlur(const CTexture& tex, wlr_box* pBox, float a, int round) {
+    RASSERT((tex.m_iTexID > 0), "Attempted to draw NULL texture!");
+
+    // only the damage under the window needs the blur
+    pixman_region32_t damage;
+    pixman_region32_init(&damage);
+    pixman_region32_intersect_rect(&damage, m_RenderData.pDamage, pBox->x, pBox->y, pBox->width, pBox->height);
+
+    if (!pixman_region32_not_empty(&damage)) {
+        pixman_region32_fini(&damage);
+        return;
+    }
+
+    // blur once for all the rects, not once per rect
+    const auto POUTFB = blurFramebufferWithDamage(&m_mMonitorRenderResources[m_RenderData.pMonitor].primaryFB, &damage);
+
+    renderTextureOverBlurredFB(tex, pBox, a, round, POUTFB, &damage);
+
+    pixman_region32_fini(&damage);
+}
+
+void CHyprOpenGLImpl::renderTextureOverBlurredFB(const CTexture& tex, wlr_box* pBox, float a, int round, CFramebuffer* pBlurredFB, pixman_region32_t* pDamage) {
+    // write the window's non-opaque pixels to the stencil, leaving the colors alone
+    glClearStencil(0);
+    glClear(GL_STENCIL_BUFFER_BIT);
+
+    glEnable(GL_STENCIL_TEST);
+
+    glStencilFunc(GL_ALWAYS, 1, -1);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    renderTextureInternalWithDamage(tex, pBox, a, pDamage, round, true);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+    // then draw the blurred bg only within the stencil
+    glStencilFunc(GL_EQUAL, 1, -1);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+
+    wlr_box fullMonBox = {0, 0, m_RenderData.pMonitor->vecSize.x, m_RenderData.pMonitor->vecSize.y};
+    renderTextureInternalWithDamage(pBlurredFB->m_cTex, &fullMonBox, a, pDamage, 0);
+
+    // disable the stencil
+    glStencilMask(-1);
+    glStencilFunc(GL_ALWAYS, 1, 0xFF);
+    glDisable(GL_STENCIL_TEST);
+
+    // and the window on top
+    renderTextureInternalWithDamage(tex, pBox, a, pDamage, round);
+}
+
+void CHyprOpenGLImpl::renderBlurBackgroundCache(const std::function<void()>& renderBackground) {
+    RASSERT(m_RenderData.pMonitor, "Tried to render the blur cache without begin()!");
+
+    static const CConfigHandle<int64_t> BLUR("decoration:blur");
+
+    const auto PMONRENDERDATA = &m_mMonitorRenderResources[m_RenderData.pMonitor];
+
+    if (!PMONRENDERDATA->blurFBDirty || *BLUR == 0)
+        return;
+
+    // the cache has to hold the entire background, not only this frame's damage
+    pixman_region32_t fullDamage;
+    pixman_region32_init_rect(&fullDamage, 0, 0, (int)m_RenderData.pMonitor->vecSize.x, (int)m_RenderData.pMonitor->vecSize.y);
+
+    const auto PFRAMEDAMAGE = m_RenderData.pDamage;
+    m_RenderData.pDamage = &fullDamage;
+
+    PMONRENDERDATA->blurFB.bind();
+
+    renderBackground();
+
+    const auto POUTFB = blurFramebufferWithDamage(&PMONRENDERDATA->blurFB, &fullDamage);
+
+    // keep the result, the mirrors are reused by every live blur
+    PMONRENDERDATA->blurFB.bind();
+
+    wlr_box fullMonBox = {0, 0, m_RenderData.pMonitor->vecSize.x, m_RenderData.pMonitor->vecSize.y};
+    renderTextureInternalWithDamage(POUTFB->m_cTex, &fullMonBox, 255.f, &fullDamage, 0);
+
+    PMONRENDERDATA->primaryFB.bind();
+
+    m_RenderData.pDamage = PFRAMEDAMAGE;
+    pixman_region32_fini(&fullDamage);
+
+    PMONRENDERDATA->blurFBDirty = false;
+}
+
+void CHyprOpenGLImpl::markBlurDirtyForMonitor(SMonitor* pMonitor) {
+    const auto IT = m_mMonitorRenderResources.find(pMonitor);
+
+    if (IT != m_mMonitorRenderResources.end())
+        IT->second.blurFBDirty = true;
+}
+
 void pushVert2D(float x, float y, float* arr, int& counter, wlr_box* box) {
     // 0-1 space god damnit
     arr[counter * 2 + 0] = x / box->width;
@@ -483,12 +1132,9 @@ void CHyprOpenGLImpl::renderBorder(wlr_box* box, const CColor& col, int thick, i
 
     wlr_matrix_transpose(glMatrix, glMatrix);
 
-    if (col.a == 255.f)
-        glDisable(GL_BLEND);
-    else
-        glEnable(GL_BLEND);
+    setBlend(col.a != 255.f);
 
-    glUseProgram(m_shQUAD.program);
+    useProgram(m_shQUAD.program);
 
     glUniformMatrix3fv(m_shQUAD.proj, 1, GL_FALSE, glMatrix);
     glUniform4f(m_shQUAD.color, col.r / 255.f, col.g / 255.f, col.b / 255.f, col.a / 255.f);
@@ -543,14 +1189,19 @@ void CHyprOpenGLImpl::renderBorder(wlr_box* box, const CColor& col, int thick, i
         pushVert2D(x1 + (sin((i * (360.f / (float)SIDES) * 3.141526f / 180)) * radius), y1 + (cos((i * (360.f / (float)SIDES) * 3.141526f / 180)) * radius), verts, vertNo, box);
     }
 
-    glVertexAttribPointer(m_shQUAD.posAttrib, 2, GL_FLOAT, GL_FALSE, 0, verts);
+    glBindBuffer(GL_ARRAY_BUFFER, m_iBorderVBO);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(float) * vertNo * 2, verts);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    glEnableVertexAttribArray(m_shQUAD.posAttrib);
+    bindVertices(m_iBorderVAO, m_iBorderVBO, m_shQUAD.posAttrib);
 
     glLineWidth(thick);
-    glDrawArrays(GL_LINE_STRIP, 0, 41);
 
-    glDisableVertexAttribArray(m_shQUAD.posAttrib);
+    // borders are translucent more often than not, so only draw them inside the damage,
+    // otherwise they'd keep blending over themselves in the undamaged parts of the FB
+    drawArraysWithDamage(GL_LINE_STRIP, vertNo, m_RenderData.pDamage);
+
+    unbindVertices(m_shQUAD.posAttrib);
 }
 
 void CHyprOpenGLImpl::makeWindowSnapshot(CWindow* pWindow) {
@@ -625,7 +1276,7 @@ void CHyprOpenGLImpl::renderSnapshot(CWindow** pWindow) {
 
     wlr_box windowBox = {0, 0, PMONITOR->vecSize.x, PMONITOR->vecSize.y};
 
-    renderTextureInternal(it->second.m_cTex, &windowBox, PWINDOW->m_fAlpha, 0);
+    renderTextureInternalWithDamage(it->second.m_cTex, &windowBox, PWINDOW->m_fAlpha, m_RenderData.pDamage, 0);
 }
 
 void CHyprOpenGLImpl::createBGTextureForMonitor(SMonitor* pMonitor) {
@@ -637,7 +1288,7 @@ void CHyprOpenGLImpl::createBGTextureForMonitor(SMonitor* pMonitor) {
 
     PTEX->allocate();
 
-    Debug::log(LOG, "Allocated texture for BGTex");
+    DEBUGLOG(LOG, "Allocated texture for BGTex");
 
     // check if wallpapers exist
     if (!std::filesystem::exists("/usr/share/hyprland/wall_8K.png"))
@@ -676,7 +1327,9 @@ void CHyprOpenGLImpl::createBGTextureForMonitor(SMonitor* pMonitor) {
     cairo_surface_destroy(CAIROSURFACE);
     cairo_destroy(CAIRO);
 
-    Debug::log(LOG, "Background created for monitor %s", pMonitor->szName.c_str());
+    markBlurDirtyForMonitor(pMonitor);
+
+    DEBUGLOG(LOG, "Background created for monitor %s", pMonitor->szName.c_str());
 }
 
 void CHyprOpenGLImpl::clearWithTex() {
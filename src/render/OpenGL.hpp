@@ -6,6 +6,8 @@
 #include <wlr/render/egl.h>
 #include <list>
 #include <unordered_map>
+#include <array>
+#include <vector>
 
 #include "Shaders.hpp"
 #include "Shader.hpp"
@@ -24,16 +26,50 @@ inline const float fullVerts[] = {
     0, 1,  // bottom left
 };
 
+enum BLURMETHODS {
+    BLUR_METHOD_INVALID = -1,
+    BLUR_METHOD_GAUSSIAN = 0,
+    BLUR_METHOD_KAWASE
+};
+
+enum SHADERFEATURES : uint8_t {
+    SH_FEAT_ROUNDING      = 1 << 0,
+    SH_FEAT_DISCARDOPAQUE = 1 << 1,
+    SH_FEAT_ALPHAONE      = 1 << 2,
+
+    SH_FEAT_ALL           = SH_FEAT_ROUNDING | SH_FEAT_DISCARDOPAQUE | SH_FEAT_ALPHAONE,
+};
+
 struct SCurrentRenderData {
     SMonitor*   pMonitor = nullptr;
     float       projection[9];
 
     pixman_region32_t* pDamage = nullptr;
+
+    bool        directToOutput = false; // nothing reads back this frame, so primaryFB is skipped
+};
+
+struct SGLCallCounter {
+    uint64_t    issued = 0;
+    uint64_t    avoided = 0;
+};
+
+struct SGLStateStats {
+    SGLCallCounter useProgram;
+    SGLCallCounter blend;
+    SGLCallCounter activeTexture;
+    SGLCallCounter texParameter;
 };
 
 struct SMonitorRenderData {
     CFramebuffer primaryFB;
     CFramebuffer mirrorFB;
+    CFramebuffer mirrorSwapFB; // for the kawase ping-pong
+
+    CFramebuffer blurFB;       // blurred wallpaper + background / bottom layers, shared by the tiled windows
+    bool         blurFBDirty = true;
+
+    bool         primaryFBStale = false; // frames went straight to the output, primaryFB missed them
 
     CTexture     stencilTex;
 };
@@ -43,18 +79,21 @@ public:
 
     CHyprOpenGLImpl();
 
-    void    begin(SMonitor*, pixman_region32_t*);
+    void    begin(SMonitor*, pixman_region32_t*, bool directToOutput = false);
     void    end();
 
     void    renderRect(wlr_box*, const CColor&);
     void    renderTexture(wlr_texture*, wlr_box*, float a, int round = 0);
     void    renderTexture(const CTexture&, wlr_box*, float a, int round = 0);
-    void    renderTextureWithBlur(const CTexture&, wlr_box*, float a, int round = 0);
+    void    renderTextureWithBlur(const CTexture&, wlr_box*, float a, int round = 0, bool cachedBlur = false);
     void    renderBorder(wlr_box*, const CColor&, int thick = 1, int round = 0);
 
     void    makeWindowSnapshot(CWindow*);
     void    renderSnapshot(CWindow**);
 
+    void    renderBlurBackgroundCache(const std::function<void()>& renderBackground);
+    void    markBlurDirtyForMonitor(SMonitor*);
+
     void    clear(const CColor&);
     void    clearWithTex();
     void    scissor(const wlr_box*);
@@ -69,7 +108,20 @@ public:
     std::unordered_map<SMonitor*, SMonitorRenderData> m_mMonitorRenderResources;
     std::unordered_map<SMonitor*, CTexture> m_mMonitorBGTextures;
 
+    SGLStateStats m_sGLStateStats;
+
 private:
+    // what we last set, so redundant calls can be skipped
+    struct SGLState {
+        GLuint                      program = 0;
+        int                         blend = -1; // -1 is unknown
+        GLenum                      activeTexture = 0;
+        // textures set to GL_LINEAR this frame. A frame draws a handful, a linear scan beats hashing;
+        // once it's full the rest just get the call.
+        std::array<GLuint, 32>      linearFiltered;
+        size_t                      linearFilteredCount = 0;
+    }                       m_sGLState;
+
     std::list<GLuint>       m_lBuffers;
     std::list<GLuint>       m_lTextures;
 
@@ -78,19 +130,58 @@ private:
 
     // Shaders
     SQuad                   m_shQUAD;
-    CShader                 m_shRGBA;
-    CShader                 m_shRGBX;
-    CShader                 m_shEXT;
+    std::unordered_map<uint32_t, CShader> m_mTexShaders; // texture type << 8 | SHADERFEATURES
     CShader                 m_shBLUR1;
     CShader                 m_shBLUR2;
+    CShader                 m_shBLURDOWN;
+    CShader                 m_shBLURUP;
     //
 
+    // Vertex buffers, uploaded once and kept on the GPU
+    GLuint                  m_iQuadVBO = 0;
+    GLuint                  m_iBorderVBO = 0;
+    GLuint                  m_iBorderVAO = 0;
+    GLuint                  m_iDamageVBO = 0;       // a quad cut to the damage rects, streamed per draw
+    std::vector<float>      m_vDamageVerts;         // kept around so it doesn't allocate every draw
+
+    // compiled programs are kept on disk, keyed by the driver and the sources.
+    // An empty dir means the driver can't give us the binaries.
+    std::string             m_szShaderCacheDir = "";
+    int                     m_iProgramsFromCache = 0;
+    int                     m_iProgramsCompiled = 0;
+#ifdef GLES2
+    PFNGLGETPROGRAMBINARYOESPROC m_pGetProgramBinary = nullptr;
+    PFNGLPROGRAMBINARYOESPROC    m_pProgramBinary = nullptr;
+#endif
+
+    void                    initShaderCache();
+    GLuint                  loadCachedProgram(const std::string& path);
+    void                    saveCachedProgram(GLuint prog, const std::string& path);
+
     GLuint                  createProgram(const std::string&, const std::string&);
     GLuint                  compileShader(const GLuint&, std::string);
+    void                    initShader(CShader*, GLuint prog);
+    CShader*                getTexShader(TEXTURETYPE, uint8_t features);
     void                    createBGTextureForMonitor(SMonitor*);
 
+    void                    createVAO(GLuint*, GLuint vbo, GLint posAttrib, GLint texAttrib = -1);
+    void                    bindVertices(GLuint vao, GLuint vbo, GLint posAttrib, GLint texAttrib = -1);
+    void                    unbindVertices(GLint posAttrib, GLint texAttrib = -1);
+    void                    drawArraysWithDamage(GLenum mode, GLsizei count, pixman_region32_t*);
+    void                    drawQuadWithDamage(const float* glMatrix, pixman_region32_t*, GLuint vao, GLuint damageVao, GLint posAttrib, GLint texAttrib = -1);
+
+    void                    useProgram(GLuint);
+    void                    setBlend(bool);
+    void                    activeTexture(GLenum);
+    void                    setLinearFilter(GLenum target, GLuint tex);
+    void                    invalidateGLState();
+
     void                    renderTextureInternal(const CTexture&, wlr_box* pBox, float a, int round = 0, bool discardOpaque = false);
+    void                    renderTextureInternalWithDamage(const CTexture&, wlr_box* pBox, float a, pixman_region32_t* pDamage, int round = 0, bool discardOpaque = false);
     void                    renderTextureWithBlurInternal(const CTexture&, wlr_box*, float a, int round = 0);
+    void                    renderTextureWithKawaseBlur(const CTexture&, wlr_box*, float a, int round = 0);
+    void                    renderTextureOverBlurredFB(const CTexture&, wlr_box*, float a, int round, CFramebuffer* pBlurredFB, pixman_region32_t* pDamage);
+    CFramebuffer*           blurFramebufferWithDamage(CFramebuffer* pSource, pixman_region32_t*);
     
 };
 
@@ -1,7 +1,14 @@
 #include "Renderer.hpp"
 #include "../Compositor.hpp"
 
+CHyprRenderer::CHyprRenderer() {
+    if (ISDEBUG)
+        selfCheckDirectScanout();
+}
+
 void renderSurface(struct wlr_surface* surface, int x, int y, void* data) {
+    static const CConfigHandle<int64_t> ROUNDING("decoration:rounding");
+
     const auto TEXTURE = wlr_surface_get_texture(surface);
     const auto RDATA = (SRenderData*)data;
 
@@ -20,9 +27,9 @@ void renderSurface(struct wlr_surface* surface, int x, int y, void* data) {
     scaleBox(&windowBox, RDATA->output->scale);
 
     if (RDATA->surface && surface == RDATA->surface)
-        g_pHyprOpenGL->renderTextureWithBlur(TEXTURE, &windowBox, RDATA->fadeAlpha * RDATA->alpha, RDATA->dontRound ? 0 : g_pConfigManager->getInt("decoration:rounding"));
+        g_pHyprOpenGL->renderTextureWithBlur(TEXTURE, &windowBox, RDATA->fadeAlpha * RDATA->alpha, RDATA->dontRound ? 0 : *ROUNDING, RDATA->cachedBlur);
     else
-        g_pHyprOpenGL->renderTexture(TEXTURE, &windowBox, RDATA->fadeAlpha * RDATA->alpha, RDATA->dontRound ? 0 : g_pConfigManager->getInt("decoration:rounding"));
+        g_pHyprOpenGL->renderTexture(TEXTURE, &windowBox, RDATA->fadeAlpha * RDATA->alpha, RDATA->dontRound ? 0 : *ROUNDING);
 
     wlr_surface_send_frame_done(surface, RDATA->when);
 
@@ -46,27 +53,379 @@ bool shouldRenderWindow(CWindow* pWindow, SMonitor* pMonitor) {
     return false;
 }
 
-void CHyprRenderer::renderWorkspaceWithFullscreenWindow(SMonitor* pMonitor, CWorkspace* pWorkspace, timespec* time) {
-    CWindow* pWorkspaceWindow = nullptr;
+// Adds the part of the surface that is fully opaque, in output coords, to pRegion.
+void addSurfaceOpaqueRegion(wlr_surface* pSurface, const Vector2D& pos, int rounding, SMonitor* pMonitor, pixman_region32_t* pRegion) {
+    const auto TEXTURE = wlr_surface_get_texture(pSurface);
 
-    for (auto& w : g_pCompositor->m_lWindows) {
-        if (w.m_iWorkspaceID != pWorkspace->m_iID || !w.m_bIsFullscreen)
-            continue;
+    if (!TEXTURE)
+        return;
 
-        // found it!
-        renderWindow(&w, pMonitor, time, false);
+    const int W = pSurface->current.width;
+    const int H = pSurface->current.height;
 
-        pWorkspaceWindow = &w;
+    pixman_region32_t opaque;
+    pixman_region32_init(&opaque);
+
+    if (CTexture(TEXTURE).m_iType == TEXTURE_RGBX)
+        pixman_region32_union_rect(&opaque, &opaque, 0, 0, W, H);
+    else
+        pixman_region32_intersect_rect(&opaque, &pSurface->opaque_region, 0, 0, W, H);
+
+    // the rounded corners get discarded in the shader
+    if (rounding > 0 && pixman_region32_not_empty(&opaque)) {
+        pixman_region32_t corners;
+        pixman_region32_init_rect(&corners, 0, 0, rounding, rounding);
+        pixman_region32_union_rect(&corners, &corners, W - rounding, 0, rounding, rounding);
+        pixman_region32_union_rect(&corners, &corners, 0, H - rounding, rounding, rounding);
+        pixman_region32_union_rect(&corners, &corners, W - rounding, H - rounding, rounding, rounding);
+
+        pixman_region32_subtract(&opaque, &opaque, &corners);
+        pixman_region32_fini(&corners);
     }
 
-    // then render windows over fullscreen
-    for (auto& w : g_pCompositor->m_lWindows) {
-        if (w.m_iWorkspaceID != pWorkspaceWindow->m_iWorkspaceID || !w.m_bCreatedOverFullscreen || !w.m_bIsMapped)
+    pixman_region32_translate(&opaque, (int)(pos.x - pMonitor->vecPosition.x), (int)(pos.y - pMonitor->vecPosition.y));
+    wlr_region_scale(&opaque, &opaque, pMonitor->scale);
+
+    pixman_region32_union(pRegion, pRegion, &opaque);
+    pixman_region32_fini(&opaque);
+}
+
+void addWindowOpaqueRegion(CWindow* pWindow, SMonitor* pMonitor, pixman_region32_t* pRegion) {
+    static const CConfigHandle<float> ACTIVEOPACITY("decoration:active_opacity");
+    static const CConfigHandle<float> INACTIVEOPACITY("decoration:inactive_opacity");
+    static const CConfigHandle<int64_t> ROUNDING("decoration:rounding");
+
+    if (pWindow->m_bFadingOut || pWindow->m_bHidden || pWindow->m_fAlpha < 255.f)
+        return;
+
+    const auto OPACITY = pWindow == g_pCompositor->m_pLastWindow ? *ACTIVEOPACITY : *INACTIVEOPACITY;
+
+    if (OPACITY < 1.f)
+        return;
+
+    const auto PSURFACE = g_pXWaylandManager->getWindowSurface(pWindow);
+
+    if (!PSURFACE)
+        return;
+
+    // the toplevel is stretched to its real size, so only trust its opaque region if that's a no-op
+    if (PSURFACE->current.width != (int)pWindow->m_vRealSize.x || PSURFACE->current.height != (int)pWindow->m_vRealSize.y)
+        return;
+
+    addSurfaceOpaqueRegion(PSURFACE, pWindow->m_vRealPosition, pWindow->m_bIsFullscreen ? 0 : *ROUNDING, pMonitor, pRegion);
+}
+
+void CHyprRenderer::renderWindowsWithOcclusion(SMonitor* pMonitor, timespec* time, bool occludeWithTopLayers) {
+    const auto PFRAMEDAMAGE = g_pHyprOpenGL->m_RenderData.pDamage;
+    const auto& windows = pMonitor->renderList;
+    const auto& onMonitor = pMonitor->renderListOnMonitor;
+
+    pixman_region32_t opaqueAbove;
+    pixman_region32_init(&opaqueAbove);
+
+    if (occludeWithTopLayers) {
+        for (auto& layer : {ZWLR_LAYER_SHELL_V1_LAYER_TOP, ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY}) {
+            for (auto& ls : pMonitor->renderListLayers[layer])
+                addSurfaceOpaqueRegion(ls->layerSurface->surface, Vector2D(ls->geometry.x, ls->geometry.y), 0, pMonitor, &opaqueAbove);
+        }
+    }
+
+    // top to bottom, every window only has to draw what isn't covered by opaque stuff above it
+    std::vector<pixman_region32_t> windowDamage(windows.size());
+    for (int i = (int)windows.size() - 1; i >= 0; --i) {
+        pixman_region32_init(&windowDamage[i]);
+
+        // nothing to draw if it's not on this monitor right now
+        if (!onMonitor[i])
             continue;
 
-        renderWindow(&w, pMonitor, time, true);
+        pixman_region32_subtract(&windowDamage[i], PFRAMEDAMAGE, &opaqueAbove);
+
+        addWindowOpaqueRegion(windows[i], pMonitor, &opaqueAbove);
+    }
+
+    // and then draw them back to front as usual
+    for (size_t i = 0; i < windows.size(); ++i) {
+        if (pixman_region32_not_empty(&windowDamage[i])) {
+            g_pHyprOpenGL->m_RenderData.pDamage = &windowDamage[i];
+            renderWindow(windows[i], pMonitor, time, !windows[i]->m_bIsFullscreen);
+        } else if (onMonitor[i]) {
+            // covered or undamaged, but it's still on screen and waits for its frame callback like everyone else
+            sendFrameEventsToWindow(windows[i], time);
+        }
+
+        pixman_region32_fini(&windowDamage[i]);
     }
 
+    g_pHyprOpenGL->m_RenderData.pDamage = PFRAMEDAMAGE;
+
+    pixman_region32_fini(&opaqueAbove);
+}
+
+void countSurface(wlr_surface* surface, int x, int y, void* data) {
+    *(int*)data += 1;
+}
+
+CWindow* CHyprRenderer::getDirectScanoutCandidate(SMonitor* pMonitor) {
+    static const CConfigHandle<int64_t> DIRECTSCANOUT("general:direct_scanout");
+    static const CConfigHandle<float> ACTIVEOPACITY("decoration:active_opacity");
+    static const CConfigHandle<float> INACTIVEOPACITY("decoration:inactive_opacity");
+
+    if (!*DIRECTSCANOUT)
+        return nullptr;
+
+    const auto PWORKSPACE = g_pCompositor->getWorkspaceByID(pMonitor->activeWorkspace);
+
+    if (!PWORKSPACE || !PWORKSPACE->m_bHasFullscreenWindow)
+        return nullptr;
+
+    const auto WORKSPACEWINDOWS = g_pCompositor->m_mWorkspaceWindows.find(PWORKSPACE->m_iID);
+
+    if (WORKSPACEWINDOWS == g_pCompositor->m_mWorkspaceWindows.end())
+        return nullptr;
+
+    updateRenderList(pMonitor);
+
+    SDirectScanoutInputs inputs;
+    CWindow* pCandidate = nullptr;
+
+    for (auto& w : WORKSPACEWINDOWS->second.windows) {
+        if (w->m_bIsFullscreen) {
+            if (pCandidate)
+                return nullptr;
+
+            pCandidate = w;
+        } else if (w->m_bCreatedOverFullscreen && w->m_bIsMapped) {
+            inputs.windowOverFullscreen = true;
+        }
+    }
+
+    if (!pCandidate)
+        return nullptr;
+
+    inputs.composited = pMonitor->renderListDragIcon || (pMonitor == &g_pCompositor->m_lMonitors.front() && g_pHyprError->active()) || pMonitor->output->software_cursor_locks > 0;
+
+    wlr_output_cursor* cursor;
+    wl_list_for_each(cursor, &pMonitor->output->cursors, link) {
+        if (cursor->enabled && cursor->visible && cursor != pMonitor->output->hardware_cursor)
+            inputs.composited = true;
+    }
+
+    inputs.mapped = pCandidate->m_bIsMapped;
+    inputs.hidden = pCandidate->m_bHidden;
+    inputs.fadingOut = pCandidate->m_bFadingOut;
+    inputs.alpha = pCandidate->m_fAlpha;
+    inputs.opacity = pCandidate == g_pCompositor->m_pLastWindow ? *ACTIVEOPACITY : *INACTIVEOPACITY;
+    inputs.windowPosition = pCandidate->m_vRealPosition;
+    inputs.windowSize = pCandidate->m_vRealSize;
+    inputs.monitorPosition = pMonitor->vecPosition;
+    inputs.monitorSize = pMonitor->vecSize;
+    inputs.outputSize = Vector2D(pMonitor->output->width, pMonitor->output->height);
+    inputs.outputScale = pMonitor->output->scale;
+    inputs.outputTransform = pMonitor->output->transform;
+
+    const auto PSURFACE = inputs.mapped ? g_pXWaylandManager->getWindowSurface(pCandidate) : nullptr;
+
+    if (PSURFACE && PSURFACE->buffer) {
+        inputs.hasBuffer = true;
+        inputs.bufferSize = Vector2D(PSURFACE->buffer->base.width, PSURFACE->buffer->base.height);
+        inputs.surfaceScale = PSURFACE->current.scale;
+        inputs.surfaceTransform = PSURFACE->current.transform;
+
+        if (pCandidate->m_bIsX11)
+            wlr_surface_for_each_surface(PSURFACE, countSurface, &inputs.surfaces);
+        else
+            wlr_xdg_surface_for_each_surface(pCandidate->m_uSurface.xdg, countSurface, &inputs.surfaces);
+    }
+
+    return canScanoutDirectly(inputs) ? pCandidate : nullptr;
+}
+
+bool CHyprRenderer::canScanoutDirectly(const SDirectScanoutInputs& inputs) {
+    // anything drawn over the fullscreen window needs composition
+    if (inputs.composited || inputs.windowOverFullscreen)
+        return false;
+
+    if (!inputs.mapped || inputs.hidden || inputs.fadingOut || inputs.alpha < 255.f || inputs.opacity < 1.f)
+        return false;
+
+    // still animating into place
+    if (inputs.windowPosition != inputs.monitorPosition || inputs.windowSize != inputs.monitorSize)
+        return false;
+
+    // subsurfaces and popups have to be composited
+    if (!inputs.hasBuffer || inputs.surfaces != 1)
+        return false;
+
+    return inputs.bufferSize == inputs.outputSize && inputs.surfaceScale == inputs.outputScale && inputs.surfaceTransform == inputs.outputTransform;
+}
+
+// Debug builds only. Scanout can't be exercised without real outputs, so this checks the decision on its own
+// against a fullscreen window that can go out directly, and each thing that should stop it.
+void CHyprRenderer::selfCheckDirectScanout() {
+    SDirectScanoutInputs base;
+    base.mapped = true;
+    base.alpha = 255.f;
+    base.opacity = 1.f;
+    base.windowPosition = Vector2D(1920, 0);
+    base.windowSize = Vector2D(1280, 720);
+    base.monitorPosition = Vector2D(1920, 0);
+    base.monitorSize = Vector2D(1280, 720);
+    base.hasBuffer = true;
+    base.surfaces = 1;
+    base.bufferSize = Vector2D(2560, 1440);
+    base.outputSize = Vector2D(2560, 1440);
+    base.surfaceScale = 2.f;
+    base.outputScale = 2.f;
+
+    RASSERT(canScanoutDirectly(base), "Direct scanout self-check: a plain fullscreen window was refused");
+
+    const std::vector<std::pair<const char*, void (*)(SDirectScanoutInputs&)>> REFUSALS = {
+        {"composited on top", [](SDirectScanoutInputs& i) { i.composited = true; }},
+        {"window over fullscreen", [](SDirectScanoutInputs& i) { i.windowOverFullscreen = true; }},
+        {"unmapped", [](SDirectScanoutInputs& i) { i.mapped = false; }},
+        {"hidden", [](SDirectScanoutInputs& i) { i.hidden = true; }},
+        {"fading out", [](SDirectScanoutInputs& i) { i.fadingOut = true; }},
+        {"fading in", [](SDirectScanoutInputs& i) { i.alpha = 200.f; }},
+        {"translucent", [](SDirectScanoutInputs& i) { i.opacity = 0.9f; }},
+        {"moving", [](SDirectScanoutInputs& i) { i.windowPosition = Vector2D(1900, 0); }},
+        {"resizing", [](SDirectScanoutInputs& i) { i.windowSize = Vector2D(1200, 720); }},
+        {"no buffer", [](SDirectScanoutInputs& i) { i.hasBuffer = false; }},
+        {"subsurfaces", [](SDirectScanoutInputs& i) { i.surfaces = 2; }},
+        {"buffer size", [](SDirectScanoutInputs& i) { i.bufferSize = Vector2D(1280, 720); }},
+        {"scale", [](SDirectScanoutInputs& i) { i.surfaceScale = 1.f; }},
+        {"transform", [](SDirectScanoutInputs& i) { i.surfaceTransform = WL_OUTPUT_TRANSFORM_90; }},
+    };
+
+    for (auto& [NAME, apply] : REFUSALS) {
+        auto inputs = base;
+        apply(inputs);
+        RASSERT(!canScanoutDirectly(inputs), "Direct scanout self-check: allowed with %s", NAME);
+    }
+}
+
+bool CHyprRenderer::attemptDirectScanout(SMonitor* pMonitor) {
+    const auto PCANDIDATE = getDirectScanoutCandidate(pMonitor);
+
+    if (!PCANDIDATE)
+        return false;
+
+    // the buffer on screen is still the current one
+    if (pMonitor->directScanout && !pixman_region32_not_empty(&pMonitor->damage->current))
+        return true;
+
+    const auto PSURFACE = g_pXWaylandManager->getWindowSurface(PCANDIDATE);
+
+    wlr_output_attach_buffer(pMonitor->output, &PSURFACE->buffer->base);
+
+    if (!wlr_output_test(pMonitor->output)) {
+        wlr_output_rollback(pMonitor->output);
+        return false;
+    }
+
+    if (!wlr_output_commit(pMonitor->output))
+        return false;
+
+    if (!pMonitor->directScanout)
+        DEBUGLOG(LOG, "Monitor %s: started direct scanout of %x", pMonitor->szName.c_str(), PCANDIDATE);
+
+    return true;
+}
+
+bool CHyprRenderer::shouldRenderDirectlyToOutput(SMonitor* pMonitor) {
+    static const CConfigHandle<int64_t> BYPASSPRIMARYFB("general:bypass_primary_fb");
+    static const CConfigHandle<int64_t> BLUR("decoration:blur");
+
+    if (!*BYPASSPRIMARYFB)
+        return false;
+
+    // blur is the only thing reading primaryFB back, and only windows and the drag icon get it
+    if (*BLUR == 0)
+        return true;
+
+    updateRenderList(pMonitor);
+
+    return pMonitor->renderList.empty() && !pMonitor->renderListDragIcon;
+}
+
+void CHyprRenderer::updateRenderList(SMonitor* pMonitor) {
+    const auto PWORKSPACE = g_pCompositor->getWorkspaceByID(pMonitor->activeWorkspace);
+    const bool FULLSCREEN = PWORKSPACE && PWORKSPACE->m_bHasFullscreenWindow;
+
+    if (pMonitor->renderListEpoch != g_pCompositor->m_iSceneEpoch || pMonitor->renderListFullscreen != FULLSCREEN) {
+        pMonitor->renderListEpoch = g_pCompositor->m_iSceneEpoch;
+        pMonitor->renderListFullscreen = FULLSCREEN;
+        pMonitor->renderListGeometryEpoch = UINT64_MAX;
+
+        rebuildRenderList(pMonitor, PWORKSPACE);
+    }
+
+    // windows move every animation frame without the scene changing, so which of them are on this monitor is kept apart
+    if (pMonitor->renderListGeometryEpoch != g_pCompositor->m_iGeometryEpoch) {
+        pMonitor->renderListGeometryEpoch = g_pCompositor->m_iGeometryEpoch;
+
+        pMonitor->renderListOnMonitor.resize(pMonitor->renderList.size());
+        for (size_t i = 0; i < pMonitor->renderList.size(); ++i)
+            pMonitor->renderListOnMonitor[i] = shouldRenderWindow(pMonitor->renderList[i], pMonitor);
+    }
+}
+
+void CHyprRenderer::rebuildRenderList(SMonitor* pMonitor, CWorkspace* pWorkspace) {
+    pMonitor->renderList.clear();
+    pMonitor->renderListTiled = 0;
+
+    for (size_t i = 0; i < pMonitor->m_aLayerSurfaceLists.size(); ++i) {
+        pMonitor->renderListLayers[i].clear();
+
+        for (auto& ls : pMonitor->m_aLayerSurfaceLists[i]) {
+            if (ls->layerSurface && ls->layerSurface->mapped && ls->layerSurface->surface)
+                pMonitor->renderListLayers[i].push_back(ls);
+        }
+    }
+
+    pMonitor->renderListDragIcon = g_pInputManager->m_sDrag.dragIcon && g_pInputManager->m_sDrag.iconMapped && g_pInputManager->m_sDrag.dragIcon->surface;
+
+    if (pMonitor->renderListFullscreen) {
+        // the fullscreen window, then the ones opened over it
+        for (auto& w : g_pCompositor->m_lWindows) {
+            if (w.m_iWorkspaceID == pWorkspace->m_iID && w.m_bIsFullscreen)
+                pMonitor->renderList.push_back(&w);
+        }
+
+        for (auto& w : g_pCompositor->m_lWindows) {
+            if (w.m_iWorkspaceID == pWorkspace->m_iID && w.m_bCreatedOverFullscreen && w.m_bIsMapped)
+                pMonitor->renderList.push_back(&w);
+        }
+
+        return;
+    }
+
+    // tiled first, floating on top
+    for (const auto FLOATING : {false, true}) {
+        for (auto& w : g_pCompositor->m_lWindows) {
+            if (!g_pCompositor->windowValidMapped(&w) && !w.m_bFadingOut)
+                continue;
+
+            if (w.m_bIsFloating != FLOATING)
+                continue;
+
+            // where exactly it is changes every animation frame, so whether it's on this monitor is kept apart
+            if (!g_pCompositor->isWorkspaceVisible(w.m_iWorkspaceID))
+                continue;
+
+            pMonitor->renderList.push_back(&w);
+        }
+
+        if (!FLOATING)
+            pMonitor->renderListTiled = pMonitor->renderList.size();
+    }
+}
+
+void CHyprRenderer::renderWorkspaceWithFullscreenWindow(SMonitor* pMonitor, timespec* time) {
+    // the render list holds the fullscreen window and the windows over it.
+    // The fullscreen window hides the top layers
+    renderWindowsWithOcclusion(pMonitor, time, false);
+
     renderDragIcon(pMonitor, time);
 
     // if correct monitor draw hyprerror
@@ -75,6 +434,9 @@ void CHyprRenderer::renderWorkspaceWithFullscreenWindow(SMonitor* pMonitor, CWor
 }
 
 void CHyprRenderer::renderWindow(CWindow* pWindow, SMonitor* pMonitor, timespec* time, bool decorate) {
+    static const CConfigHandle<float> ACTIVEOPACITY("decoration:active_opacity");
+    static const CConfigHandle<float> INACTIVEOPACITY("decoration:inactive_opacity");
+
     if (pWindow->m_bHidden)
         return;
 
@@ -90,7 +452,10 @@ void CHyprRenderer::renderWindow(CWindow* pWindow, SMonitor* pMonitor, timespec*
     renderdata.h = pWindow->m_vRealSize.y;
     renderdata.dontRound = pWindow->m_bIsFullscreen;
     renderdata.fadeAlpha = pWindow->m_fAlpha;
-    renderdata.alpha = pWindow == g_pCompositor->m_pLastWindow ? g_pConfigManager->getFloat("decoration:active_opacity") : g_pConfigManager->getFloat("decoration:inactive_opacity");
+    renderdata.alpha = pWindow == g_pCompositor->m_pLastWindow ? *ACTIVEOPACITY : *INACTIVEOPACITY;
+    // the cache is only good for tiled windows sitting still, fully opaque, right on the background layers
+    const bool ANIMATING = pWindow->m_vRealPosition != pWindow->m_vEffectivePosition || pWindow->m_vRealSize != pWindow->m_vEffectiveSize;
+    renderdata.cachedBlur = !pWindow->m_bIsFloating && pWindow->m_fAlpha >= 255.f && !ANIMATING;
 
     wlr_surface_for_each_surface(g_pXWaylandManager->getWindowSurface(pWindow), renderSurface, &renderdata);
 
@@ -110,70 +475,62 @@ void CHyprRenderer::renderWindow(CWindow* pWindow, SMonitor* pMonitor, timespec*
     } 
 }
 
+void CHyprRenderer::renderLayers(SMonitor* pMonitor, zwlr_layer_shell_v1_layer layer, timespec* time) {
+    for (auto& ls : pMonitor->renderListLayers[layer]) {
+        SRenderData renderdata = {pMonitor->output, time, ls->geometry.x, ls->geometry.y};
+        wlr_surface_for_each_surface(ls->layerSurface->surface, renderSurface, &renderdata);
+    }
+}
+
+void CHyprRenderer::renderLayerPopups(SMonitor* pMonitor, timespec* time) {
+    for (auto& layer : pMonitor->renderListLayers) {
+        for (auto& ls : layer) {
+            SRenderData renderdata = {pMonitor->output, time, ls->geometry.x, ls->geometry.y};
+            wlr_layer_surface_v1_for_each_popup_surface(ls->layerSurface, renderSurface, &renderdata);
+        }
+    }
+}
+
+void CHyprRenderer::renderLayersBelowWindows(SMonitor* pMonitor, timespec* time) {
+    renderLayers(pMonitor, ZWLR_LAYER_SHELL_V1_LAYER_BACKGROUND, time);
+    renderLayers(pMonitor, ZWLR_LAYER_SHELL_V1_LAYER_BOTTOM, time);
+}
+
 void CHyprRenderer::renderAllClientsForMonitor(const int& ID, timespec* time) {
     const auto PMONITOR = g_pCompositor->getMonitorFromID(ID);
 
     if (!PMONITOR)
         return;
 
+    updateRenderList(PMONITOR);
+
     // Render layer surfaces below windows for monitor
-    for (auto& ls : PMONITOR->m_aLayerSurfaceLists[ZWLR_LAYER_SHELL_V1_LAYER_BACKGROUND]) {
-        SRenderData renderdata = {PMONITOR->output, time, ls->geometry.x, ls->geometry.y};
-        wlr_surface_for_each_surface(ls->layerSurface->surface, renderSurface, &renderdata);
-    }
-    for (auto& ls : PMONITOR->m_aLayerSurfaceLists[ZWLR_LAYER_SHELL_V1_LAYER_BOTTOM]) {
-        SRenderData renderdata = {PMONITOR->output, time, ls->geometry.x, ls->geometry.y};
-        wlr_surface_for_each_surface(ls->layerSurface->surface, renderSurface, &renderdata);
-    }
+    renderLayersBelowWindows(PMONITOR, time);
 
     // if there is a fullscreen window, render it and then do not render anymore.
     // fullscreen window will hide other windows and top layers
-    const auto PWORKSPACE = g_pCompositor->getWorkspaceByID(PMONITOR->activeWorkspace);
-
-    if (PWORKSPACE->m_bHasFullscreenWindow) {
-        renderWorkspaceWithFullscreenWindow(PMONITOR, PWORKSPACE, time);
+    if (PMONITOR->renderListFullscreen) {
+        renderWorkspaceWithFullscreenWindow(PMONITOR, time);
         return;
     }
 
-    // Non-floating
-    for (auto& w : g_pCompositor->m_lWindows) {
-        if (!g_pCompositor->windowValidMapped(&w) && !w.m_bFadingOut)
-            continue;
-
-        if (w.m_bIsFloating)
-            continue;  // floating are in second pass
-
-        if (!shouldRenderWindow(&w, PMONITOR))
-            continue;
-
-        // render the bad boy
-        renderWindow(&w, PMONITOR, time, true);
+    // tiled windows sit right on the background, so they all share one blur of it.
+    // (Re)made only when there's something to use it and the background changed.
+    if (PMONITOR->renderListTiled > 0) {
+        g_pHyprOpenGL->renderBlurBackgroundCache([&]() {
+            g_pHyprOpenGL->clear(CColor(11, 11, 11, 255));
+            g_pHyprOpenGL->clearWithTex();
+            renderLayersBelowWindows(PMONITOR, time);
+        });
     }
 
-    // floating on top
-    for (auto& w : g_pCompositor->m_lWindows) {
-        if (!g_pCompositor->windowValidMapped(&w) && !w.m_bFadingOut)
-            continue;
-
-        if (!w.m_bIsFloating)
-            continue;
-
-        if (!shouldRenderWindow(&w, PMONITOR))
-            continue;
-
-        // render the bad boy
-        renderWindow(&w, PMONITOR, time, true);
-    }
+    // render the bad boys
+    renderWindowsWithOcclusion(PMONITOR, time, true);
 
     // Render surfaces above windows for monitor
-    for (auto& ls : PMONITOR->m_aLayerSurfaceLists[ZWLR_LAYER_SHELL_V1_LAYER_TOP]) {
-        SRenderData renderdata = {PMONITOR->output, time, ls->geometry.x, ls->geometry.y};
-        wlr_surface_for_each_surface(ls->layerSurface->surface, renderSurface, &renderdata);
-    }
-    for (auto& ls : PMONITOR->m_aLayerSurfaceLists[ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY]) {
-        SRenderData renderdata = {PMONITOR->output, time, ls->geometry.x, ls->geometry.y};
-        wlr_surface_for_each_surface(ls->layerSurface->surface, renderSurface, &renderdata);
-    }
+    renderLayers(PMONITOR, ZWLR_LAYER_SHELL_V1_LAYER_TOP, time);
+    renderLayers(PMONITOR, ZWLR_LAYER_SHELL_V1_LAYER_OVERLAY, time);
+    renderLayerPopups(PMONITOR, time);
 
     renderDragIcon(PMONITOR, time);
 
@@ -214,13 +571,17 @@ void CHyprRenderer::outputMgrApplyTest(wlr_output_configuration_v1* config, bool
             wlr_output_rollback(head->state.output);
     }
 
+    // outputs may have moved, which changes which windows each of them shows
+    if (noError && !test)
+        g_pCompositor->sceneChanged();
+
     if (noError)
         wlr_output_configuration_v1_send_succeeded(config);
     else
         wlr_output_configuration_v1_send_failed(config);
     wlr_output_configuration_v1_destroy(config);
 
-    Debug::log(LOG, "OutputMgr Applied/Tested.");
+    DEBUGLOG(LOG, "OutputMgr Applied/Tested.");
 }
 
 // taken from Sway.
@@ -364,7 +725,7 @@ void CHyprRenderer::arrangeLayerArray(SMonitor* pMonitor, const std::list<SLayer
             box.y -= PSTATE->margin.bottom;
         }
         if (box.width <= 0 || box.height <= 0) {
-            Debug::log(ERR, "LayerSurface %x has a negative/zero w/h???", ls);
+            DEBUGLOG(ERR, "LayerSurface %x has a negative/zero w/h???", ls);
             continue;
         }
         // Apply
@@ -374,7 +735,7 @@ void CHyprRenderer::arrangeLayerArray(SMonitor* pMonitor, const std::list<SLayer
 
         wlr_layer_surface_v1_configure(ls->layerSurface, box.width, box.height);
 
-        Debug::log(LOG, "LayerSurface %x arranged: x: %i y: %i w: %i h: %i with margins: t: %i l: %i r: %i b: %i", &ls, box.x, box.y, box.width, box.height, PSTATE->margin.top, PSTATE->margin.left, PSTATE->margin.right, PSTATE->margin.bottom);
+        DEBUGLOG(LOG, "LayerSurface %x arranged: x: %i y: %i w: %i h: %i with margins: t: %i l: %i r: %i b: %i", &ls, box.x, box.y, box.width, box.height, PSTATE->margin.top, PSTATE->margin.left, PSTATE->margin.right, PSTATE->margin.bottom);
     }
 }
 
@@ -399,11 +760,14 @@ void CHyprRenderer::arrangeLayersForMonitor(const int& monitor) {
     PMONITOR->vecReservedTopLeft = Vector2D(usableArea.x, usableArea.y) - PMONITOR->vecPosition;
     PMONITOR->vecReservedBottomRight = PMONITOR->vecSize - Vector2D(usableArea.width, usableArea.height) - PMONITOR->vecReservedTopLeft;
 
-    Debug::log(LOG, "Monitor %s layers arranged: reserved: %f %f %f %f", PMONITOR->szName.c_str(), PMONITOR->vecReservedTopLeft.x, PMONITOR->vecReservedTopLeft.y, PMONITOR->vecReservedBottomRight.x, PMONITOR->vecReservedBottomRight.y);
+    DEBUGLOG(LOG, "Monitor %s layers arranged: reserved: %f %f %f %f", PMONITOR->szName.c_str(), PMONITOR->vecReservedTopLeft.x, PMONITOR->vecReservedTopLeft.y, PMONITOR->vecReservedBottomRight.x, PMONITOR->vecReservedBottomRight.y);
 }
 
 void CHyprRenderer::drawBorderForWindow(CWindow* pWindow, SMonitor* pMonitor, float alpha) {
-    const auto BORDERSIZE = g_pConfigManager->getInt("general:border_size");
+    static const CConfigHandle<int64_t> BORDERSIZEHANDLE("general:border_size");
+    static const CConfigHandle<int64_t> ROUNDING("decoration:rounding");
+
+    const auto BORDERSIZE = *BORDERSIZEHANDLE;
 
     if (BORDERSIZE < 1)
         return;
@@ -416,7 +780,7 @@ void CHyprRenderer::drawBorderForWindow(CWindow* pWindow, SMonitor* pMonitor, fl
 
     // top
     wlr_box border = {correctPos.x - BORDERSIZE / 2.f, correctPos.y - BORDERSIZE / 2.f, pWindow->m_vRealSize.x + BORDERSIZE, pWindow->m_vRealSize.y + BORDERSIZE};
-    g_pHyprOpenGL->renderBorder(&border, BORDERCOL, BORDERSIZE, g_pConfigManager->getInt("decoration:rounding"));
+    g_pHyprOpenGL->renderBorder(&border, BORDERCOL, BORDERSIZE, *ROUNDING);
 }
 
 void CHyprRenderer::damageSurface(wlr_surface* pSurface, double x, double y) {
@@ -427,16 +791,30 @@ void CHyprRenderer::damageSurface(wlr_surface* pSurface, double x, double y) {
     pixman_region32_init(&damageBox);
     wlr_surface_get_effective_damage(pSurface, &damageBox);
 
+    if (!pixman_region32_not_empty(&damageBox)) {
+        pixman_region32_fini(&damageBox);
+        return;
+    }
+
     pixman_region32_translate(&damageBox, x, y);
 
+    // only damage the monitors the damage actually lands on, in their local, scaled coords
+    pixman_region32_t damageBoxForMonitor;
+    pixman_region32_init(&damageBoxForMonitor);
+
     for (auto& m : g_pCompositor->m_lMonitors) {
-        double lx = 0, ly = 0;
-        wlr_output_layout_output_coords(g_pCompositor->m_sWLROutputLayout, m.output, &lx, &ly);
-        pixman_region32_translate(&damageBox, lx, ly);
-        wlr_output_damage_add(m.damage, &damageBox);
-        pixman_region32_translate(&damageBox, -lx, -ly);
+        pixman_region32_intersect_rect(&damageBoxForMonitor, &damageBox, (int)m.vecPosition.x, (int)m.vecPosition.y, (int)m.vecSize.x, (int)m.vecSize.y);
+
+        if (!pixman_region32_not_empty(&damageBoxForMonitor))
+            continue;
+
+        pixman_region32_translate(&damageBoxForMonitor, -(int)m.vecPosition.x, -(int)m.vecPosition.y);
+        wlr_region_scale(&damageBoxForMonitor, &damageBoxForMonitor, m.scale);
+
+        wlr_output_damage_add(m.damage, &damageBoxForMonitor);
     }
 
+    pixman_region32_fini(&damageBoxForMonitor);
     pixman_region32_fini(&damageBox);
 }
 
@@ -450,7 +828,8 @@ void CHyprRenderer::damageWindow(CWindow* pWindow) {
             wlr_output_damage_add_box(m.damage, &damageBox);
     } else {
         // damage by real size & pos + border size * 2 (JIC)
-        const auto BORDERSIZE = g_pConfigManager->getInt("general:border_size");
+        static const CConfigHandle<int64_t> BORDERSIZEHANDLE("general:border_size");
+        const auto BORDERSIZE = *BORDERSIZEHANDLE;
         wlr_box damageBox = { pWindow->m_vRealPosition.x - BORDERSIZE - 1, pWindow->m_vRealPosition.y - BORDERSIZE - 1, pWindow->m_vRealSize.x + 2 * BORDERSIZE + 2, pWindow->m_vRealSize.y + 2 * BORDERSIZE + 2};
         for (auto& m : g_pCompositor->m_lMonitors)
             wlr_output_damage_add_box(m.damage, &damageBox);
@@ -469,8 +848,38 @@ void CHyprRenderer::damageBox(wlr_box* pBox) {
     }
 }
 
+void sendFrameDone(wlr_surface* surface, int x, int y, void* data) {
+    wlr_surface_send_frame_done(surface, (timespec*)data);
+}
+
+void CHyprRenderer::sendFrameEventsToWindow(CWindow* pWindow, timespec* time) {
+    if (!g_pCompositor->windowValidMapped(pWindow) || pWindow->m_bHidden)
+        return;
+
+    wlr_surface_for_each_surface(g_pXWaylandManager->getWindowSurface(pWindow), sendFrameDone, time);
+
+    if (!pWindow->m_bIsX11)
+        wlr_xdg_surface_for_each_popup_surface(pWindow->m_uSurface.xdg, sendFrameDone, time);
+}
+
+void CHyprRenderer::sendFrameEventsToMonitor(SMonitor* pMonitor, timespec* time) {
+    // when nothing got damaged we skip rendering entirely, but clients still
+    // wait for their frame callbacks before drawing again.
+    updateRenderList(pMonitor);
+
+    for (size_t i = 0; i < pMonitor->renderList.size(); ++i) {
+        if (pMonitor->renderListOnMonitor[i])
+            sendFrameEventsToWindow(pMonitor->renderList[i], time);
+    }
+
+    for (auto& layer : pMonitor->renderListLayers) {
+        for (auto& ls : layer)
+            wlr_layer_surface_v1_for_each_surface(ls->layerSurface, sendFrameDone, time);
+    }
+}
+
 void CHyprRenderer::renderDragIcon(SMonitor* pMonitor, timespec* time) {
-    if (!(g_pInputManager->m_sDrag.dragIcon && g_pInputManager->m_sDrag.iconMapped && g_pInputManager->m_sDrag.dragIcon->surface))
+    if (!pMonitor->renderListDragIcon)
         return;
 
     SRenderData renderdata = {pMonitor->output, time, g_pInputManager->m_sDrag.pos.x, g_pInputManager->m_sDrag.pos.y};
@@ -2,6 +2,7 @@
 
 #include "../defines.hpp"
 #include <list>
+#include <vector>
 #include "../helpers/Monitor.hpp"
 #include "../helpers/Workspace.hpp"
 #include "../Window.hpp"
@@ -15,8 +16,33 @@ enum DAMAGETRACKINGMODES {
     DAMAGE_TRACKING_FULL
 };
 
+// What the direct scanout decision looks at, read off the monitor and its one fullscreen window.
+// Plain values only, so canScanoutDirectly can be checked without a backend.
+struct SDirectScanoutInputs {
+    bool        composited = false;             // something of ours goes on top: drag icon, error bar, a software cursor
+    bool        windowOverFullscreen = false;   // a mapped window was created over the fullscreen one
+    bool        mapped = false;
+    bool        hidden = false;
+    bool        fadingOut = false;
+    float       alpha = 0.f;                    // m_fAlpha, 0 - 255
+    float       opacity = 0.f;                  // decoration:active_opacity or inactive_opacity, whichever applies
+    Vector2D    windowPosition;
+    Vector2D    windowSize;
+    Vector2D    monitorPosition;
+    Vector2D    monitorSize;
+    bool        hasBuffer = false;
+    int         surfaces = 0;                   // the window's surface tree, subsurfaces and popups included
+    Vector2D    bufferSize;
+    Vector2D    outputSize;
+    float       surfaceScale = 1.f;
+    float       outputScale = 1.f;
+    int         surfaceTransform = 0;
+    int         outputTransform = 0;
+};
+
 class CHyprRenderer {
 public:
+    CHyprRenderer();
 
     void                renderAllClientsForMonitor(const int&, timespec*);
     void                outputMgrApplyTest(wlr_output_configuration_v1*, bool);
@@ -25,15 +51,28 @@ public:
     void                damageWindow(CWindow*);
     void                damageBox(wlr_box*);
     void                damageMonitor(SMonitor*);
+    void                sendFrameEventsToMonitor(SMonitor*, timespec*);
+    void                sendFrameEventsToWindow(CWindow*, timespec*);
+    CWindow*            getDirectScanoutCandidate(SMonitor*);
+    bool                attemptDirectScanout(SMonitor*);
+    static bool         canScanoutDirectly(const SDirectScanoutInputs&);
+    bool                shouldRenderDirectlyToOutput(SMonitor*);
+    void                updateRenderList(SMonitor*);
 
     DAMAGETRACKINGMODES damageTrackingModeFromStr(const std::string&);
 
 private:
     void                arrangeLayerArray(SMonitor*, const std::list<SLayerSurface*>&, bool, wlr_box*);
     void                drawBorderForWindow(CWindow*, SMonitor*, float a = 255.f);
-    void                renderWorkspaceWithFullscreenWindow(SMonitor*, CWorkspace*, timespec*);
+    void                renderWorkspaceWithFullscreenWindow(SMonitor*, timespec*);
     void                renderWindow(CWindow*, SMonitor*, timespec*, bool);
+    void                renderWindowsWithOcclusion(SMonitor*, timespec*, bool occludeWithTopLayers);
     void                renderDragIcon(SMonitor*, timespec*);
+    void                renderLayers(SMonitor*, zwlr_layer_shell_v1_layer, timespec*);
+    void                renderLayerPopups(SMonitor*, timespec*);
+    void                renderLayersBelowWindows(SMonitor*, timespec*);
+    void                rebuildRenderList(SMonitor*, CWorkspace*);
+    void                selfCheckDirectScanout();
 
 
     friend class CHyprOpenGLImpl;
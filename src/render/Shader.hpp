@@ -7,6 +7,9 @@ struct SQuad {
     GLint proj;
     GLint color;
     GLint posAttrib;
+
+    GLuint vao = 0;
+    GLuint damageVao = 0;
 };
 
 class CShader {
@@ -17,5 +20,17 @@ public:
     GLint alpha;
     GLint posAttrib;
     GLint texAttrib;
-    GLint discardOpaque;
+
+    // rounding
+    GLint topLeft;
+    GLint bottomRight;
+    GLint fullSize;
+    GLint radius;
+
+    // blur
+    GLint resolution;
+    GLint halfpixel;
+
+    GLuint vao = 0;       // quad VAO, unused on GLES2
+    GLuint damageVao = 0; // same for the damage verts
 };
\ No newline at end of file
@@ -36,28 +36,58 @@ void main() {
 	v_texcoord = texcoord;
 })#";
 
-inline const std::string TEXFRAGSRCRGBA = R"#(
+// All the texture shaders are built from this one, with the defines below prepended.
+// Every combination is compiled on its own, so a draw only pays for the features it uses:
+//  EXTERNAL       - the texture is an EGLImage
+//  RGBX           - ignore the texture's alpha
+//  ROUNDING       - discard the pixels outside the rounded corners
+//  DISCARDOPAQUE  - discard the opaque pixels (for the blur stencil)
+//  ALPHAONE       - no alpha multiplier
+inline const std::string TEXFRAGSRC = R"#(
+#ifdef EXTERNAL
+#extension GL_OES_EGL_image_external : require
+#endif
+
 precision mediump float;
 varying vec2 v_texcoord; // is in 0-1
+
+#ifdef EXTERNAL
+uniform samplerExternalOES tex;
+#else
 uniform sampler2D tex;
+#endif
+
+#ifndef ALPHAONE
 uniform float alpha;
+#endif
 
+#ifdef ROUNDING
 uniform vec2 topLeft;
 uniform vec2 bottomRight;
 uniform vec2 fullSize;
 uniform float radius;
-
-uniform int discardOpaque;
+#endif
 
 void main() {
 
 	vec4 pixColor = texture2D(tex, v_texcoord);
 
-	if (discardOpaque == 1 && pixColor[3] * alpha == 1.0) {
+#ifdef RGBX
+	pixColor[3] = 1.0;
+#endif
+
+#ifdef DISCARDOPAQUE
+#ifdef ALPHAONE
+	if (pixColor[3] == 1.0) {
+#else
+	if (pixColor[3] * alpha == 1.0) {
+#endif
 		discard;
 		return;
 	}
+#endif
 
+#ifdef ROUNDING
 	vec2 pixCoord = fullSize * v_texcoord;
 
 	if (pixCoord[0] < topLeft[0]) {
@@ -92,66 +122,13 @@ void main() {
 			}
 		}
 	}
+#endif
 
+#ifdef ALPHAONE
+	gl_FragColor = pixColor;
+#else
 	gl_FragColor = pixColor * alpha;
-})#";
-
-inline const std::string TEXFRAGSRCRGBX = R"#(
-precision mediump float;
-varying vec2 v_texcoord;
-uniform sampler2D tex;
-uniform float alpha;
-
-uniform vec2 topLeft;
-uniform vec2 bottomRight;
-uniform vec2 fullSize;
-uniform float radius;
-
-uniform int discardOpaque;
-
-void main() {
-
-	if (discardOpaque == 1 && alpha == 1.0) {
-		discard;
-		return;
-	}
-	
-	vec2 pixCoord = fullSize * v_texcoord;
-
-	if (pixCoord[0] < topLeft[0]) {
-		// we're close left
-		if (pixCoord[1] < topLeft[1]) {
-			// top
-			if (distance(topLeft, pixCoord) > radius) {
-				discard;
-				return;
-			}
-		} else if (pixCoord[1] > bottomRight[1]) {
-			// bottom
-			if (distance(vec2(topLeft[0], bottomRight[1]), pixCoord) > radius) {
-				discard;
-				return;
-			}
-		}
-	}
-	else if (pixCoord[0] > bottomRight[0]) {
-		// we're close right
-		if (pixCoord[1] < topLeft[1]) {
-			// top
-			if (distance(vec2(bottomRight[0], topLeft[1]), pixCoord) > radius) {
-				discard;
-				return;
-			}
-		} else if (pixCoord[1] > bottomRight[1]) {
-			// bottom
-			if (distance(bottomRight, pixCoord) > radius) {
-				discard;
-				return;
-			}
-		}
-	}
-
-	gl_FragColor = vec4(texture2D(tex, v_texcoord).rgb, 1.0) * alpha;
+#endif
 })#";
 
 // thanks to Loadus
@@ -255,64 +232,50 @@ void main() {
 
 )#";
 
-inline const std::string TEXFRAGSRCEXT = R"#(
-#extension GL_OES_EGL_image_external : require
-
+// Dual Kawase, downsampled blur.
+// Every pass renders into half / double the size of the previous one inside the same FB,
+// so the taps per pixel stay the same no matter the radius.
+inline const std::string FRAGBLURDOWN = R"#(
 precision mediump float;
-varying vec2 v_texcoord;
-uniform samplerExternalOES texture0;
-uniform float alpha;
+varying vec2 v_texcoord; // is in 0-1
+uniform sampler2D tex;
 
-uniform vec2 topLeft;
-uniform vec2 bottomRight;
-uniform vec2 fullSize;
 uniform float radius;
-
-uniform int discardOpaque;
+uniform vec2 halfpixel;
 
 void main() {
+	vec2 uv = v_texcoord * 2.0;
 
-	vec4 pixColor = texture2D(texture0, v_texcoord);
+	vec4 sum = texture2D(tex, uv) * 4.0;
+	sum += texture2D(tex, uv - halfpixel.xy * radius);
+	sum += texture2D(tex, uv + halfpixel.xy * radius);
+	sum += texture2D(tex, uv + vec2(halfpixel.x, -halfpixel.y) * radius);
+	sum += texture2D(tex, uv - vec2(halfpixel.x, -halfpixel.y) * radius);
 
-	if (discardOpaque == 1 && pixColor[3] * alpha == 1.0) {
-		discard;
-		return;
-	}
+	gl_FragColor = sum / 8.0;
+}
+)#";
 
-	vec2 pixCoord = fullSize * v_texcoord;
+inline const std::string FRAGBLURUP = R"#(
+precision mediump float;
+varying vec2 v_texcoord; // is in 0-1
+uniform sampler2D tex;
 
-	if (pixCoord[0] < topLeft[0]) {
-		// we're close left
-		if (pixCoord[1] < topLeft[1]) {
-			// top
-			if (distance(topLeft, pixCoord) > radius) {
-				discard;
-				return;
-			}
-		} else if (pixCoord[1] > bottomRight[1]) {
-			// bottom
-			if (distance(vec2(topLeft[0], bottomRight[1]), pixCoord) > radius) {
-				discard;
-				return;
-			}
-		}
-	}
-	else if (pixCoord[0] > bottomRight[0]) {
-		// we're close right
-		if (pixCoord[1] < topLeft[1]) {
-			// top
-			if (distance(vec2(bottomRight[0], topLeft[1]), pixCoord) > radius) {
-				discard;
-				return;
-			}
-		} else if (pixCoord[1] > bottomRight[1]) {
-			// bottom
-			if (distance(bottomRight, pixCoord) > radius) {
-				discard;
-				return;
-			}
-		}
-	}
+uniform float radius;
+uniform vec2 halfpixel;
 
-	gl_FragColor = pixColor * alpha;
-})#";
+void main() {
+	vec2 uv = v_texcoord / 2.0;
+
+	vec4 sum = texture2D(tex, uv + vec2(-halfpixel.x * 2.0, 0.0) * radius);
+	sum += texture2D(tex, uv + vec2(-halfpixel.x, halfpixel.y) * radius) * 2.0;
+	sum += texture2D(tex, uv + vec2(0.0, halfpixel.y * 2.0) * radius);
+	sum += texture2D(tex, uv + vec2(halfpixel.x, halfpixel.y) * radius) * 2.0;
+	sum += texture2D(tex, uv + vec2(halfpixel.x * 2.0, 0.0) * radius);
+	sum += texture2D(tex, uv + vec2(halfpixel.x, -halfpixel.y) * radius) * 2.0;
+	sum += texture2D(tex, uv + vec2(0.0, -halfpixel.y * 2.0) * radius);
+	sum += texture2D(tex, uv + vec2(-halfpixel.x, -halfpixel.y) * radius) * 2.0;
+
+	gl_FragColor = sum / 12.0;
+}
+)#";